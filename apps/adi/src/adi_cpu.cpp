@@ -143,29 +143,66 @@ int main(int argc, char* argv[]) {
     if(strcmp((char*)options[opt_index].name,"help") == 0) print_help();
   }
 
-  if( nx>N_MAX || ny>N_MAX || nz>N_MAX ) {
-    printf("Dimension can not exceed N_MAX=%d due to hard-coded local array sizes\n", N_MAX);
-    exit(1);
-  }
-
-  // allocate memory for arrays
+  // allocate memory for arrays, backed by huge pages for the strided y- and z-solves
   nx_pad = (1+((nx-1)/SIMD_VEC))*SIMD_VEC; // Compute padding for vecotrization
-  h_u  = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_tmp= (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_du = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_ax = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_bx = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_cx = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_ay = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_by = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_cy = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_az = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_bz = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
-  h_cz = (FP *)_mm_malloc(sizeof(FP)*nx_pad*ny*nz,SIMD_WIDTH);
+  tridMalloc((void**)&h_u, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_tmp, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_du, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_ax, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_bx, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_cx, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_ay, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_by, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_cy, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_az, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_bz, sizeof(FP)*nx_pad*ny*nz);
+  tridMalloc((void**)&h_cz, sizeof(FP)*nx_pad*ny*nz);
 
   printf("\nGrid dimensions: %d x %d x %d\n", nx, ny, nz);
   printf("Check parameters: SIMD_WIDTH = %d, sizeof(FP) = %d, nx_pad = %d \n",SIMD_WIDTH,sizeof(FP),nx_pad);
 
+  // Tridiagonal solver option arguemnt's setup
+  int ndim = 3;  // Number of dimensions of the (hyper)cubic data structure.
+  int dims[3];   // Array containing the sizes of each ndim dimensions. size(dims) == ndim <=MAXDIM
+  int pads[3];   // Padded sizes along each ndim number of dimensions
+  dims[0] = nx;
+  dims[1] = ny;
+  dims[2] = nz;
+  pads[0] = nx_pad;
+  pads[1] = dims[1];
+  pads[2] = dims[2];
+
+  // With -opt 1 the coefficients, which don't change between iterations, are factorized in the first iteration and
+  // later iterations solve only the r.h.s. with the three stored factor arrays: this saves the divisions, but not
+  // memory traffic. With -opt 2 the constant coefficients set by preproc() are factorized as Toeplitz systems and
+  // only the r.h.s. is read. Lines on the boundary are identity systems with zero r.h.s. and their solution is zero
+  // either way.
+  tridPlan_t plan_x, plan_y, plan_z;
+  #if FPPREC == 0
+    tridSmtsvPlanCreate(&plan_x, ndim, 0, dims, pads);
+    tridSmtsvPlanCreate(&plan_y, ndim, 1, dims, pads);
+    tridSmtsvPlanCreate(&plan_z, ndim, 2, dims, pads);
+  #elif FPPREC == 1
+    tridDmtsvPlanCreate(&plan_x, ndim, 0, dims, pads);
+    tridDmtsvPlanCreate(&plan_y, ndim, 1, dims, pads);
+    tridDmtsvPlanCreate(&plan_z, ndim, 2, dims, pads);
+  #endif
+
+  // First touch: the coefficients of a direction are placed on the NUMA nodes of the threads that solve them. u, du
+  // and tmp are read by all three solves, so they are interleaved.
+  tridPlanFirstTouch(plan_x, h_ax, 0);
+  tridPlanFirstTouch(plan_x, h_bx, 0);
+  tridPlanFirstTouch(plan_x, h_cx, 0);
+  tridPlanFirstTouch(plan_y, h_ay, 0);
+  tridPlanFirstTouch(plan_y, h_by, 0);
+  tridPlanFirstTouch(plan_y, h_cy, 0);
+  tridPlanFirstTouch(plan_z, h_az, 0);
+  tridPlanFirstTouch(plan_z, h_bz, 0);
+  tridPlanFirstTouch(plan_z, h_cz, 0);
+  tridPlanFirstTouch(plan_z, h_u,   1);
+  tridPlanFirstTouch(plan_z, h_du,  1);
+  tridPlanFirstTouch(plan_z, h_tmp, 1);
+
   // Initialize
   for(k=0; k<nz; k++) {
     for(j=0; j<ny; j++) {
@@ -258,25 +295,23 @@ int main(int argc, char* argv[]) {
         }
       }
     #else
-      // Tridiagonal solver option arguemnt's setup
-      int ndim = 3;  // Number of dimensions of the (hyper)cubic data structure.
-      int dims[3];   // Array containing the sizes of each ndim dimensions. size(dims) == ndim <=MAXDIM
-      int pads[3];   // Padded sizes along each ndim number of dimensions
-      dims[0] = nx;
-      dims[1] = ny;
-      dims[2] = nz;
-      pads[0] = dims[0];
-      pads[1] = dims[1];
-      pads[2] = dims[2];
-
-      //initTridMultiDimBatchSolve(ndim, dims, pads);
-
-      int solvedim = 0;   // user chosen dimension for which the solution is performed
-      #if FPPREC == 0
-        tridSmtsvStridedBatch(h_ax, h_bx, h_cx, h_du, h_u, ndim, solvedim, dims, pads);
-      #elif FPPREC == 1
-        tridDmtsvStridedBatch(h_ax, h_bx, h_cx, h_du, h_u, ndim, solvedim, dims, pads);
-      #endif
+      if(opt == 1 || opt == 2) {
+        #if FPPREC == 0
+          if(it == 0 && opt == 1) tridSmtsvPlanFactorize(plan_x, h_ax, h_bx, h_cx);
+          if(it == 0 && opt == 2) tridSmtsvPlanFactorizeToeplitz(plan_x, -0.5*lambda, 1.0+lambda, -0.5*lambda, 1.0, 0.0, 0.0, 1.0);
+          tridSmtsvPlanSolve(plan_x, h_du, h_u);
+        #elif FPPREC == 1
+          if(it == 0 && opt == 1) tridDmtsvPlanFactorize(plan_x, h_ax, h_bx, h_cx);
+          if(it == 0 && opt == 2) tridDmtsvPlanFactorizeToeplitz(plan_x, -0.5*lambda, 1.0+lambda, -0.5*lambda, 1.0, 0.0, 0.0, 1.0);
+          tridDmtsvPlanSolve(plan_x, h_du, h_u);
+        #endif
+      } else {
+        #if FPPREC == 0
+          tridSmtsvStridedBatch(h_ax, h_bx, h_cx, h_du, h_u, ndim, 0, dims, pads);
+        #elif FPPREC == 1
+          tridDmtsvStridedBatch(h_ax, h_bx, h_cx, h_du, h_u, ndim, 0, dims, pads);
+        #endif
+      }
 
       //  #pragma omp parallel for private(k,j,ind) collapse(2) //schedule(guided) //private(j2) //private(j,c2,d2) //collapse(2)
       //  for(k=0; k<nz; k++) {
@@ -333,47 +368,22 @@ int main(int argc, char* argv[]) {
         }
       }
     #else
-      #pragma omp parallel for collapse(2) private(k,i,ind) //schedule(guided)
-      for(k=0; k<nz; k++) {
-        //for(i=0; i<nx; i++) {
-        //  ind = k*nx*ny + i;
-        //  trid_scalar_vec<FP>(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad);
-        for(i=0; i<ROUND_DOWN(nx,SIMD_VEC); i+=SIMD_VEC) {
-          ind = k*nx_pad*ny + i;
-          #ifdef __MIC__
-            //printf("&h_ay[ind] = %ld;  &((F32vec16*)&(h_ay[ind]))[0] = %ld \n", &h_ay[ind], &((F32vec16*)&(h_ay[ind]))[0]);
-            //trid_scalar_vec<FP,VECTOR,0>(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-            #if FPPREC == 0
-              trid_scalar_vecS(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-            #elif FPPREC == 1
-              trid_scalar_vecD(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-            #endif
-            //if( ((long)(__m512*)&(h_by[0])) % 64 != 0 ) printf("NOT ALIGNED\n");
-            //printf("SIMD_WIDTH = %d \n",SIMD_WIDTH);
-          #else 
-            //trid_scalar_vec<FP,VECTOR,0>(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-            #if FPPREC == 0
-              trid_scalar_vecS(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-            #elif FPPREC == 1
-              trid_scalar_vecD(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-            #endif
-            //trid_y_cpu(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-          #endif
-        //trid_y_cpu(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad/SIMD_VEC);
-        }
-      }
-      if(ROUND_DOWN(nx,SIMD_VEC) < nx) { // If there is leftover, fork threads an compute it
-        #pragma omp parallel for collapse(2) private(k,i,ind)
-        for(k=0; k<nz; k++) {
-          for(i=ROUND_DOWN(nx,SIMD_VEC); i<nx; i++) {
-            ind = k*nx_pad*ny + i;
-            #if FPPREC == 0
-              trid_scalarS(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad);
-            #elif FPPREC == 1
-              trid_scalarD(&h_ay[ind], &h_by[ind], &h_cy[ind], &h_du[ind], &h_u[ind], ny, nx_pad);
-            #endif
-          }
-        }
+      if(opt == 1 || opt == 2) {
+        #if FPPREC == 0
+          if(it == 0 && opt == 1) tridSmtsvPlanFactorize(plan_y, h_ay, h_by, h_cy);
+          if(it == 0 && opt == 2) tridSmtsvPlanFactorizeToeplitz(plan_y, -0.5*lambda, 1.0+lambda, -0.5*lambda, 1.0, 0.0, 0.0, 1.0);
+          tridSmtsvPlanSolve(plan_y, h_du, h_u);
+        #elif FPPREC == 1
+          if(it == 0 && opt == 1) tridDmtsvPlanFactorize(plan_y, h_ay, h_by, h_cy);
+          if(it == 0 && opt == 2) tridDmtsvPlanFactorizeToeplitz(plan_y, -0.5*lambda, 1.0+lambda, -0.5*lambda, 1.0, 0.0, 0.0, 1.0);
+          tridDmtsvPlanSolve(plan_y, h_du, h_u);
+        #endif
+      } else {
+        #if FPPREC == 0
+          tridSmtsvStridedBatch(h_ay, h_by, h_cy, h_du, h_u, ndim, 1, dims, pads);
+        #elif FPPREC == 1
+          tridDmtsvStridedBatch(h_ay, h_by, h_cy, h_du, h_u, ndim, 1, dims, pads);
+        #endif
       }
     #endif
     timing_end(prof, &timer, &elapsed_trid_y, "trid_y");
@@ -398,52 +408,23 @@ int main(int argc, char* argv[]) {
         }
       }
     #else
-      #pragma omp parallel for collapse(2) private(j,i,k,ind) schedule(static,1) // Interleaved scheduling for better data locality and thus lower TLB miss rate
-      for(j=0; j<ny; j++) {
-        for(i=0; i<ROUND_DOWN(nx,SIMD_VEC); i+=SIMD_VEC) {
-          ind = j*nx_pad + i;
-          #ifdef __MIC__
-            //trid_scalar_vec<FP,VECTOR,1>(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, (nx_pad/SIMD_VEC)*ny);
-            #if FPPREC == 0
-              trid_scalar_vecSInc(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, (nx_pad/SIMD_VEC)*ny);
-            #elif FPPREC == 1
-              trid_scalar_vecDInc(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, (nx_pad/SIMD_VEC)*ny);
-            #endif
-          #else
-            //trid_scalar_vec<FP,VECTOR,1>(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, (nx_pad/SIMD_VEC)*ny);
-            #if FPPREC == 0
-              trid_scalar_vecSInc(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, (nx_pad/SIMD_VEC)*ny);
-            #elif FPPREC == 1
-              trid_scalar_vecDInc(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, (nx_pad/SIMD_VEC)*ny);
-            #endif
-            //trid_z_cpu(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, (nx_pad/SIMD_VEC)*ny);
-          #endif
-
-          //for(i=0; i<nx; i++) {
-          //  ind = j*nx_pad + i;
-          //  trid_scalar(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, nx_pad*ny);
-          //  for(k=0; k<nz; k++) {
-          //    h_u[ind + k*nx_pad*ny] += h_du[ind + k*nx_pad*ny];
-          //  }
-        }
+      if(opt == 1 || opt == 2) {
+        #if FPPREC == 0
+          if(it == 0 && opt == 1) tridSmtsvPlanFactorize(plan_z, h_az, h_bz, h_cz);
+          if(it == 0 && opt == 2) tridSmtsvPlanFactorizeToeplitz(plan_z, -0.5*lambda, 1.0+lambda, -0.5*lambda, 1.0, 0.0, 0.0, 1.0);
+          tridSmtsvPlanSolveInc(plan_z, h_du, h_u);
+        #elif FPPREC == 1
+          if(it == 0 && opt == 1) tridDmtsvPlanFactorize(plan_z, h_az, h_bz, h_cz);
+          if(it == 0 && opt == 2) tridDmtsvPlanFactorizeToeplitz(plan_z, -0.5*lambda, 1.0+lambda, -0.5*lambda, 1.0, 0.0, 0.0, 1.0);
+          tridDmtsvPlanSolveInc(plan_z, h_du, h_u);
+        #endif
+      } else {
+        #if FPPREC == 0
+          tridSmtsvStridedBatchInc(h_az, h_bz, h_cz, h_du, h_u, ndim, 2, dims, pads);
+        #elif FPPREC == 1
+          tridDmtsvStridedBatchInc(h_az, h_bz, h_cz, h_du, h_u, ndim, 2, dims, pads);
+        #endif
       }
-      if(ROUND_DOWN(nx,SIMD_VEC) < nx) { // If there is leftover, fork threads an compute it
-        #pragma omp parallel for collapse(2) private(j,i,k,ind) schedule(static,1)
-        for(j=0; j<ny; j++) {
-          for(i=ROUND_DOWN(nx,SIMD_VEC); i<nx; i++) {
-            ind = j*nx_pad + i;
-            #if FPPREC == 0
-              trid_scalarS(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, nx_pad*ny);
-            #elif FPPREC == 1
-              trid_scalarD(&h_az[ind], &h_bz[ind], &h_cz[ind], &h_du[ind], &h_u[ind], nz, nx_pad*ny);
-            #endif
-            for(k=0; k<nz; k++) {
-              h_u[ind + k*nx_pad*ny] += h_du[ind + k*nx_pad*ny];
-            }
-          }
-        }
-      }
-
     #endif
     timing_end(prof, &timer, &elapsed_trid_z, "trid_z");
   }
@@ -464,17 +445,21 @@ int main(int argc, char* argv[]) {
   int ldim=nx_pad;
   #include "print_array.c"
 
-  _mm_free(h_u);
-  _mm_free(h_du);
-  _mm_free(h_ax);
-  _mm_free(h_bx);
-  _mm_free(h_cx);
-  _mm_free(h_ay);
-  _mm_free(h_by);
-  _mm_free(h_cy);
-  _mm_free(h_az);
-  _mm_free(h_bz);
-  _mm_free(h_cz);
+  tridPlanDestroy(plan_x);
+  tridPlanDestroy(plan_y);
+  tridPlanDestroy(plan_z);
+
+  tridFree(h_u);
+  tridFree(h_du);
+  tridFree(h_ax);
+  tridFree(h_bx);
+  tridFree(h_cx);
+  tridFree(h_ay);
+  tridFree(h_by);
+  tridFree(h_cy);
+  tridFree(h_az);
+  tridFree(h_bz);
+  tridFree(h_cz);
 
   printf("Done.\n");
   
@@ -149,11 +149,6 @@ int init(app_handle &app, mpi_handle &mpi, int argc, char* argv[]) {
   app.ny = app.ny_g;
   app.nz = app.nz_g;
 
-  if( app.nx>N_MAX || app.ny>N_MAX || app.nz>N_MAX ) {
-    printf("Local dimension can not exceed N_MAX=%d due to hard-coded local array sizes\n", N_MAX);
-    return -1;
-  }
-
   printf("Check parameters: SIMD_WIDTH = %d, sizeof(FP) = %d, nx_pad (padded) = %d, nx = %d, x_start_g = %d, x_end_g = %d \n", SIMD_WIDTH, sizeof(FP), app.nx_pad, app.nx, app.x_start_g, app.x_end_g);
 
   // allocate memory for arrays
@@ -0,0 +1,52 @@
+#!/bin/bash
+# Set error checking: if a statment returns other than 0, the script stops executing
+set +e
+set -u
+
+# Use this tool to compare the x-solve kernels of the CPU library on 256-1024 point lines. For every line length the
+# ADI application is run with each TRID_CPU_X_COMPACT setting and the trid_x time per element is recorded:
+#   0 - trid_x_transpose() with separate c' and d' workspaces
+#   1 - trid_x_transpose_compact() with the compact c'/d' workspace
+# With PERF=1 the runs are wrapped in perf stat, which adds the L1 data cache loads and misses and the L2 requests and
+# misses to the log. The L2 events are those of Intel cores; override PERF_EVENTS with four events for other CPUs.
+
+if [[ -z "${1:-}" ]] ; then
+	echo "Specify a CPU ADI executable, e.g. ./adi_cpu!"
+	exit
+fi
+
+BINARY=$1
+ITER=${ITER:-20}
+PERF=${PERF:-0}
+PERF_EVENTS=${PERF_EVENTS:-L1-dcache-loads,L1-dcache-load-misses,l2_rqsts.references,l2_rqsts.miss}
+NYZ=${NYZ:-128}
+
+mkdir -p log
+mkdir -p benchmark
+
+SWEEPDAT="benchmark/sweep_x_$(basename $BINARY)_ITER${ITER}.dat"
+OUTLOG=log/sweep_x_out.log
+ERRLOG=log/sweep_x_err.log
+rm -f $SWEEPDAT
+echo "[NX] [COMPACT] [TRIDX] [L1-LOADS] [L1-MISSES] [L2-REFS] [L2-MISSES]" | tee -a $SWEEPDAT
+
+for NX in 256 384 512 640 768 896 1024
+do
+  for XCOMPACT in 0 1
+  do
+    if [ $PERF == "1" ]; then
+      TRID_CPU_X_COMPACT=$XCOMPACT perf stat -x, -e $PERF_EVENTS -o $ERRLOG \
+        $BINARY -nx=$NX -ny=$NYZ -nz=$NYZ -iter=$ITER -prof=1 > $OUTLOG
+      # One line per event, in the order of PERF_EVENTS: [count],[unit],[event],...
+      COUNTS=(`grep -v "^#" $ERRLOG | grep "," | cut -d, -f1`)
+    else
+      TRID_CPU_X_COMPACT=$XCOMPACT $BINARY -nx=$NX -ny=$NYZ -nz=$NYZ -iter=$ITER -prof=1 > $OUTLOG 2> $ERRLOG
+      COUNTS=("-" "-" "-" "-")
+    fi
+    # Last line: [total] [prepro] [trid_x] [trid_y] [trid_z]
+    read -ra WORDS <<< `tail -n 1 $OUTLOG`
+    echo "$NX $XCOMPACT ${WORDS[2]} ${COUNTS[0]:--} ${COUNTS[1]:--} ${COUNTS[2]:--} ${COUNTS[3]:--}" | tee -a $SWEEPDAT
+  done
+done
+
+echo "Sweeping ended."
@@ -35,14 +35,17 @@
 #ifndef __TRID_COMMON_H
 #define __TRID_COMMON_H
 
-#if FPPREC == 0
-#  define FP float
-#  define F  f
-#elif FPPREC == 1
-#  define FP double
-#  define F 
-#else
-#  error "Macro definition FPPREC unrecognized for CUDA"
+// FP is only needed by the single precision builds (CUDA, Xeon Phi); the CPU library instantiates both precisions
+#ifdef FPPREC
+#  if FPPREC == 0
+#    define FP float
+#    define F  f
+#  elif FPPREC == 1
+#    define FP double
+#    define F 
+#  else
+#    error "Macro definition FPPREC unrecognized for CUDA"
+#  endif
 #endif
 
 #define WARP_SIZE 32
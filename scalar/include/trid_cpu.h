@@ -35,6 +35,8 @@
 #ifndef __TRID_CPU_H
 #define __TRID_CPU_H
 
+#include <stddef.h>
+
 //#include "trid_common.h"
 
 /* This is just a copy of CUSPARSE enums */
@@ -62,7 +64,17 @@ typedef enum{
 //tridStatus_t tridSmtsvStridedBatchInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int *opts, int sync);
 //tridStatus_t tridDmtsvStridedBatchInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int *opts, int sync);
 
+// Name of the vector ISA selected at runtime: "avx512", "avx2", "avx", "sse42" or "knc". Can be overridden with the
+// TRID_CPU_ISA environment variable.
+const char* tridGetCpuIsa();
+
+// Allocate size bytes aligned and padded to the widest SIMD vector. Buffers of 2 MB or more are backed by huge pages,
+// transparent ones by default, see the TRID_CPU_HUGEPAGES environment variable. Release them with tridFree().
+tridStatus_t tridMalloc(void **ptr, size_t size);
+tridStatus_t tridFree(void *ptr);
+
 tridStatus_t tridSmtsvStridedBatch(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridSmtsvStridedBatchInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
 void trid_scalarS(float* a, float* b, float* c, float* d, float* u, int N, int stride);
 //void trid_x_transposeS(float*  a, float*  b, float*  c, float*  d, float*  u, int sys_size, int sys_pad, int stride);
 void trid_x_transposeS(float* a, float* b, float* c, float* d, float* u, int sys_size, int sys_pad, int stride);
@@ -70,9 +82,152 @@ void trid_scalar_vecS(float* a, float* b, float* c, float* d, float* u, int N, i
 void trid_scalar_vecSInc(float* a, float* b, float* c, float* d, float* u, int N, int stride);
 
 tridStatus_t tridDmtsvStridedBatch(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvStridedBatchInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
 void trid_scalarD(double* a, double* b, double* c, double* d, double* u, int N, int stride);
 void trid_x_transposeD(double* a, double* b, double* c, double* d, double* u, int sys_size, int sys_pad, int stride);
 void trid_scalar_vecD(double* a, double* b, double* c, double* d, double* u, int N, int stride);
 void trid_scalar_vecDInc(double* a, double* b, double* c, double* d, double* u, int N, int stride);
 
+//
+// Multiple right hand sides: d (and u) hold nrhs arrays one after the other, each in the dims/pads layout of a, b and c.
+// The elimination is done once per system and applied to every right hand side.
+//
+tridStatus_t tridSmtsvStridedBatchNrhs(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int nrhs);
+tridStatus_t tridSmtsvStridedBatchNrhsInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int nrhs);
+tridStatus_t tridDmtsvStridedBatchNrhs(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrhs);
+tridStatus_t tridDmtsvStridedBatchNrhsInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrhs);
+
+//
+// Periodic systems: a[0] of a system couples its first row to its last unknown and c of its last row couples that row to
+// the first unknown. The systems must have at least 2 rows.
+//
+tridStatus_t tridSmtsvStridedBatchCyclic(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridSmtsvStridedBatchCyclicInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvStridedBatchCyclic(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvStridedBatchCyclicInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
+
+//
+// Mixed precision: coefficients stored in float, d and u in double. The systems are solved in single precision and
+// nrefine (usually 1 or 2) steps of iterative refinement with a double precision residual bring the solution to double
+// accuracy on the stored coefficients.
+//
+tridStatus_t tridDmtsvStridedBatchMixed(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine);
+tridStatus_t tridDmtsvStridedBatchMixedInc(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine);
+
+//
+// Coefficients of reduced precision: a, b and c in IEEE half (F16) or bfloat16 (BF16) with d and u in float, or in
+// float with d and u in double. The coefficients are converted to the precision of d as they are loaded.
+//
+tridStatus_t tridSmtsvStridedBatchCoefF16(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridSmtsvStridedBatchCoefF16Inc(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridSmtsvStridedBatchCoefBF16(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridSmtsvStridedBatchCoefBF16Inc(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvStridedBatchCoefF32(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvStridedBatchCoefF32Inc(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
+
+//
+// Partitioned solve of nsys systems of N contiguous rows, system s starting at element s*sys_pad. Every system is split
+// into chunks solved by all OpenMP threads, which pays off for a few systems of 10^6 rows or more. Systems too short to
+// split are solved as a batch.
+//
+tridStatus_t tridSgtsvPartitioned(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int sys_pad);
+tridStatus_t tridSgtsvPartitionedInc(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int sys_pad);
+tridStatus_t tridDgtsvPartitioned(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int sys_pad);
+tridStatus_t tridDgtsvPartitionedInc(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int sys_pad);
+
+//
+// Packed input: a, b, c and d of an element are the quadruple abcd[4*e] to abcd[4*e+3], element e in the usual dims and
+// pads layout. One array instead of four means one prefetch stream and a quarter of the pages per element. The solution
+// replaces d in the quadruples, the Inc variants add it to u stored in the usual layout.
+//
+tridStatus_t tridSmtsvStridedBatchPacked(float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridSmtsvStridedBatchPackedInc(const float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvStridedBatchPacked(double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvStridedBatchPackedInc(const double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads);
+
+//
+// Interleaved batch of nsys systems of N rows: element i of system s is at i*nsys_pad + s, so SIMD_VEC neighbouring
+// systems are solved in vectors without any transpose. trid?convertToInterleaved() converts from the layout with system
+// s at s*sys_pad, trid?convertFromInterleaved() converts back.
+//
+tridStatus_t tridSgtsvInterleavedBatch(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int nsys_pad);
+tridStatus_t tridSgtsvInterleavedBatchInc(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int nsys_pad);
+tridStatus_t tridDgtsvInterleavedBatch(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int nsys_pad);
+tridStatus_t tridDgtsvInterleavedBatchInc(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int nsys_pad);
+
+tridStatus_t tridSconvertToInterleaved(const float *src, float *dst, int N, int nsys, int sys_pad, int nsys_pad);
+tridStatus_t tridSconvertFromInterleaved(const float *src, float *dst, int N, int nsys, int nsys_pad, int sys_pad);
+tridStatus_t tridDconvertToInterleaved(const double *src, double *dst, int N, int nsys, int sys_pad, int nsys_pad);
+tridStatus_t tridDconvertFromInterleaved(const double *src, double *dst, int N, int nsys, int nsys_pad, int sys_pad);
+
+//
+// Ragged batch of nsys systems of different lengths: system s has lengths[s] contiguous rows starting at offsets[s].
+// Systems of similar length are packed into the lanes of SIMD vectors, the lanes of shorter systems are masked.
+//
+tridStatus_t tridSgtsvRaggedBatch(const float *a, const float *b, const float *c, float *d, float *u, const long *offsets, const int *lengths, int nsys);
+tridStatus_t tridSgtsvRaggedBatchInc(const float *a, const float *b, const float *c, float *d, float *u, const long *offsets, const int *lengths, int nsys);
+tridStatus_t tridDgtsvRaggedBatch(const double *a, const double *b, const double *c, double *d, double *u, const long *offsets, const int *lengths, int nsys);
+tridStatus_t tridDgtsvRaggedBatchInc(const double *a, const double *b, const double *c, double *d, double *u, const long *offsets, const int *lengths, int nsys);
+
+//
+// Plan API: the geometry of a batch, the offsets of its systems and the per-thread workspace are set up once by
+// trid?mtsvPlanCreate() and reused by every trid?mtsvPlanExecute() on arrays with the same dims and pads. A plan can
+// only be executed in the precision it was created for, and by one thread at a time.
+//
+typedef struct tridPlan_st *tridPlan_t;
+
+tridStatus_t tridSmtsvPlanCreate(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridSmtsvPlanExecute(tridPlan_t plan, const float *a, const float *b, const float *c, float *d, float* u);
+tridStatus_t tridSmtsvPlanExecuteInc(tridPlan_t plan, const float *a, const float *b, const float *c, float *d, float* u);
+
+tridStatus_t tridDmtsvPlanCreate(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads);
+tridStatus_t tridDmtsvPlanExecute(tridPlan_t plan, const double *a, const double *b, const double *c, double *d, double* u);
+tridStatus_t tridDmtsvPlanExecuteInc(tridPlan_t plan, const double *a, const double *b, const double *c, double *d, double* u);
+
+//
+// Factor once, solve many: when the coefficients don't change between solves, trid?mtsvPlanFactorize() stores three
+// arrays of the size of the batch in the plan: the pivot reciprocals 1/b', a/b' and the modified upper diagonal c'.
+// trid?mtsvPlanSolve() then reads d and the three factors instead of a, b, c and d, which is the same memory traffic as
+// trid?mtsvPlanExecute(): only the divisions are saved. Bandwidth bound solves with constant coefficients should use
+// trid?mtsvPlanFactorizeToeplitz() below, which reads only d.
+//
+tridStatus_t tridSmtsvPlanFactorize(tridPlan_t plan, const float *a, const float *b, const float *c);
+tridStatus_t tridSmtsvPlanSolve(tridPlan_t plan, float *d, float *u);
+tridStatus_t tridSmtsvPlanSolveInc(tridPlan_t plan, float *d, float *u);
+
+tridStatus_t tridDmtsvPlanFactorize(tridPlan_t plan, const double *a, const double *b, const double *c);
+tridStatus_t tridDmtsvPlanSolve(tridPlan_t plan, double *d, double *u);
+tridStatus_t tridDmtsvPlanSolveInc(tridPlan_t plan, double *d, double *u);
+
+//
+// Toeplitz systems: a, b and c are the same in every interior row, the first row is (b0, c0) and the last one (an, bn).
+// The factors depend only on the position in the system and are computed once for all systems of the plan, so
+// trid?mtsvPlanSolve() reads no coefficient arrays at all.
+//
+tridStatus_t tridSmtsvPlanFactorizeToeplitz(tridPlan_t plan, float a, float b, float c, float b0, float c0, float an, float bn);
+tridStatus_t tridDmtsvPlanFactorizeToeplitz(tridPlan_t plan, double a, double b, double c, double b0, double c0, double an, double bn);
+
+//
+// Output mode of plan solves: 0 writes the solution with normal stores, 1 with non-temporal (streaming) stores when the
+// systems are too long for d to stay in the L2 cache between the passes, 2 always streams. The default is 1, or
+// TRID_CPU_STREAM.
+//
+tridStatus_t tridPlanSetStream(tridPlan_t plan, int mode);
+
+//
+// NUMA placement. A plan solves contiguous blocks of systems on fixed threads: tridPlanGetPartition() returns the
+// number of systems of a thread in nsys and, if offsets isn't NULL, the offsets of their first elements (up to the
+// input value of nsys). tridPlanFirstTouch() writes zero to an array in parallel, with policy 0 on the threads that
+// solve its systems, each page, at the page size backing the array, by the thread solving most of it, so the pages end
+// up on their NUMA nodes, or with policy 1 interleaved over the threads in 2 MB blocks. Padding elements are left alone
+// by policy 0. tridPlanGetLocality() counts the elements read by the threads of each NUMA node from local and remote
+// memory, for nnodes nodes. Plans of the hybrid solver split every system between the threads; tridPlanGetPartition()
+// and tridPlanGetLocality() return TRID_STATUS_INVALID_VALUE for them.
+//
+tridStatus_t tridPlanGetPartition(tridPlan_t plan, int thread, long *offsets, long *nsys);
+tridStatus_t tridPlanFirstTouch(tridPlan_t plan, void *array, int policy);
+tridStatus_t tridPlanGetLocality(tridPlan_t plan, const void *array, int nnodes, long *local, long *remote);
+
+tridStatus_t tridPlanDestroy(tridPlan_t plan);
+
 #endif
@@ -32,6 +32,19 @@
 
  // Written by Endre Laszlo, University of Oxford, endre.laszlo@oerc.ox.ac.uk, 2013-2014 
 
+#ifdef __SSE4_2__
+inline void transpose4x4_intrinsic(__m128 __restrict__ xmm[4] ) {
+  _MM_TRANSPOSE4_PS(xmm[0], xmm[1], xmm[2], xmm[3]);
+}
+
+inline void transpose2x2_intrinsic(__m128d __restrict__ xmm[2] ) {
+  __m128d tmp;
+  tmp    = _mm_unpacklo_pd(xmm[0], xmm[1]);
+  xmm[1] = _mm_unpackhi_pd(xmm[0], xmm[1]);
+  xmm[0] = tmp;
+}
+#endif
+
 #ifdef __AVX__ 
 //void transpose8x8_intrinsic(__m256 *ymm ) {
 inline void transpose8x8_intrinsic(__m256 __restrict__ ymm[8] ) {
@@ -88,6 +101,59 @@ inline void transpose4x4_intrinsic(__m256d __restrict__ ymm[4] ) {
   ymm[3] = _mm256_shuffle_pd(tmp[2],tmp[3],0b00001111);
 }
 
+#ifdef __AVX512F__
+// AVX-512F transposes. The KNC versions below rely on _mm512_mask_permute4f128_ps, which doesn't exist in AVX-512F.
+inline void transpose16x16_intrinsic(__m512 __restrict__ zmm[16] ) {
+  __m512 tmp[16];
+
+  // Interleave pairs of rows: 2x2 blocks within every 128 bit lane
+  for(int i=0; i<8; i++) {
+    tmp[2*i  ] = _mm512_unpacklo_ps(zmm[2*i], zmm[2*i+1]);
+    tmp[2*i+1] = _mm512_unpackhi_ps(zmm[2*i], zmm[2*i+1]);
+  }
+  // 4x4 blocks within every 128 bit lane
+  for(int i=0; i<4; i++) {
+    zmm[4*i  ] = _mm512_shuffle_ps(tmp[4*i  ], tmp[4*i+2], _MM_SHUFFLE(1,0,1,0));
+    zmm[4*i+1] = _mm512_shuffle_ps(tmp[4*i  ], tmp[4*i+2], _MM_SHUFFLE(3,2,3,2));
+    zmm[4*i+2] = _mm512_shuffle_ps(tmp[4*i+1], tmp[4*i+3], _MM_SHUFFLE(1,0,1,0));
+    zmm[4*i+3] = _mm512_shuffle_ps(tmp[4*i+1], tmp[4*i+3], _MM_SHUFFLE(3,2,3,2));
+  }
+  // Exchange 128 bit lanes between 4x4 blocks of rows 0-7 and rows 8-15
+  for(int i=0; i<4; i++) {
+    tmp[i   ] = _mm512_shuffle_f32x4(zmm[i  ], zmm[i+4 ], 0x88);
+    tmp[i+4 ] = _mm512_shuffle_f32x4(zmm[i  ], zmm[i+4 ], 0xdd);
+    tmp[i+8 ] = _mm512_shuffle_f32x4(zmm[i+8], zmm[i+12], 0x88);
+    tmp[i+12] = _mm512_shuffle_f32x4(zmm[i+8], zmm[i+12], 0xdd);
+  }
+  for(int i=0; i<8; i++) {
+    zmm[i  ] = _mm512_shuffle_f32x4(tmp[i], tmp[i+8], 0x88);
+    zmm[i+8] = _mm512_shuffle_f32x4(tmp[i], tmp[i+8], 0xdd);
+  }
+}
+
+inline void transpose8x8_intrinsic(__m512d __restrict__ zmm[8] ) {
+  __m512d tmp[8];
+
+  // Interleave pairs of rows: 2x2 blocks within every 128 bit lane
+  for(int i=0; i<4; i++) {
+    tmp[2*i  ] = _mm512_unpacklo_pd(zmm[2*i], zmm[2*i+1]);
+    tmp[2*i+1] = _mm512_unpackhi_pd(zmm[2*i], zmm[2*i+1]);
+  }
+  // Exchange 128 bit lanes twice to build the 8x8 tile out of the 2x2 blocks
+  for(int i=0; i<2; i++) {
+    zmm[i  ] = _mm512_shuffle_f64x2(tmp[i  ], tmp[i+2], 0x88);
+    zmm[i+2] = _mm512_shuffle_f64x2(tmp[i  ], tmp[i+2], 0xdd);
+    zmm[i+4] = _mm512_shuffle_f64x2(tmp[i+4], tmp[i+6], 0x88);
+    zmm[i+6] = _mm512_shuffle_f64x2(tmp[i+4], tmp[i+6], 0xdd);
+  }
+  for(int i=0; i<4; i++) {
+    tmp[i  ] = _mm512_shuffle_f64x2(zmm[i], zmm[i+4], 0x88);
+    tmp[i+4] = _mm512_shuffle_f64x2(zmm[i], zmm[i+4], 0xdd);
+  }
+  for(int i=0; i<8; i++) zmm[i] = tmp[i];
+}
+#endif // __AVX512F__
+
 #else
 #ifdef __MIC__
 __attribute__((target(mic)))
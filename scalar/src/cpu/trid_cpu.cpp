@@ -33,34 +33,70 @@
 // Written by Endre Laszlo, University of Oxford, endre.laszlo@oerc.ox.ac.uk, 2013-2014 
 
 #include "trid_common.h"
-#include "trid_simd.h"
+#include "trid_simd_traits.hpp"
 #include <assert.h>
-#include "transpose.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include <omp.h>
 #include "trid_cpu.h"
+#include "trid_cpu_dispatch.hpp"
 
 #define ROUND_DOWN(N,step) (((N)/(step))*step)
+#define NRHS_BLOCK 4 // Right hand sides solved together by the nrhs kernels, their recurrences are kept in registers
+#define HYBRID_MIN_CHUNK 64      // Shortest chunk the hybrid Thomas-PCR solver splits a system into
+#define HYBRID_CHUNKS_PER_THREAD 4 // Chunks of the hybrid Thomas-PCR solver per thread, for load balance
+#define STREAM_CACHE_BYTES (1L<<20) // L2 cache size assumed when the OS doesn't report it
+#define TOUCH_PAGE_BYTES 4096      // Page size the placement of the system elements is checked at
+#define HUGE_PAGE_BYTES (2L<<20)   // Transparent huge page of x86-64
+#define INTERLEAVE_BYTES (2L<<20)  // Blocks dealt out to the threads by the interleaved first touch, one huge page
+#define LOCALITY_QUERY 4096        // Pages queried by one move_pages() call
+
+// Everything below is compiled once per vector ISA, see trid_cpu_dispatch.cpp
+namespace TRID_ISA_NS {
+
+extern const trid_cpu_kernels kernels; // Entry points of this ISA, defined at the end of the file
 
 #ifdef __MIC__ // Or #ifdef __KNC__ - more general option, future proof, __INTEL_OFFLOAD is another option
 
+template<typename REAL>
+__attribute__((target(mic)))
+inline void load(typename simd_traits<REAL>::reg * __restrict__ dst, const REAL * __restrict__ src, int n, int pad);
+
+template<typename REAL>
 __attribute__((target(mic)))
-inline void load(SIMD_REG * __restrict__ dst, const FP * __restrict__ src, int n, int pad);
+inline void store(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad);
 
+template<typename REAL>
 __attribute__((target(mic)))
-inline void store(FP * __restrict__ dst, SIMD_REG * __restrict__ src, int n, int pad);
+inline void store_inc(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad);
 
+template<typename REAL, int INC, int STREAM, int TAIL>
 __attribute__((target(mic)))
-void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP* __restrict c, FP* __restrict d, FP* __restrict u, int sys_size, int sys_pad, int stride);
+void trid_x_transpose(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int sys_size, int sys_pad, int stride, int rows, typename simd_traits<REAL>::reg* __restrict c2, typename simd_traits<REAL>::reg* __restrict d2);
 
+template<typename REAL, typename VECTOR, int INC, int STREAM>
 __attribute__((target(mic)))
-void trid_scalar_vec(const REAL* __restrict h_a, const REAL* __restrict h_b, const REAL* __restrict h_c, REAL* __restrict h_d, REAL* __restrict h_u, int N, int stride);
+void trid_scalar_vec(const REAL* __restrict h_a, const REAL* __restrict h_b, const REAL* __restrict h_c, REAL* __restrict h_d, REAL* __restrict h_u, int N, int stride, VECTOR* __restrict c2, VECTOR* __restrict d2);
 
+template<typename REAL, int INC>
 __attribute__((target(mic)))
-void trid_scalar(const FP* __restrict a, const FP* __restrict b, const FP* __restrict c, FP* __restrict d, FP* __restrict u, int N, int stride);
+void trid_scalar(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int N, int stride, REAL* __restrict c2, REAL* __restrict d2);
 
 #endif
 
 
-inline void load(SIMD_REG * __restrict__ dst, const FP * __restrict__ src, int n, int pad) {
+template<typename REAL>
+inline void load(typename simd_traits<REAL>::reg * __restrict__ dst, const REAL * __restrict__ src, int n, int pad) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
   __assume_aligned(src,SIMD_WIDTH);
   __assume_aligned(dst,SIMD_WIDTH);
   //  *(SIMD_REG*)&(u[i*N]) = *(SIMD_REG*)&(a[i*N]);
@@ -70,7 +106,11 @@ inline void load(SIMD_REG * __restrict__ dst, const FP * __restrict__ src, int n
   }
 }
 
-inline void store(FP * __restrict__ dst, SIMD_REG * __restrict__ src, int n, int pad) {
+template<typename REAL>
+inline void store(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
   __assume_aligned(src,SIMD_WIDTH);
   __assume_aligned(dst,SIMD_WIDTH);
   //  *(SIMD_REG*)&(u[i*N]) = *(SIMD_REG*)&(a[i*N]);
@@ -80,30 +120,89 @@ inline void store(FP * __restrict__ dst, SIMD_REG * __restrict__ src, int n, int
   }
 }
 
-#ifdef __MIC__ 
-  #if FPPREC == 0 
-     #define LOAD(reg,array,n,N) load(reg,array,n,N); transpose16x16_intrinsic(reg); 
-     #define STORE(array,reg,n,N) transpose16x16_intrinsic(reg); store(array,reg,n,N);
-  #elif FPPREC == 1 
-     #define LOAD(reg,array,n,N) load(reg,array,n,N); transpose8x8_intrinsic(reg); 
-     #define STORE(array,reg,n,N) transpose8x8_intrinsic(reg); store(array,reg,n,N);
-  #endif
-#elif __AVX__
-  #if FPPREC == 0
-     #define LOAD(reg,array,n,N) load(reg,array,n,N); transpose8x8_intrinsic(reg); 
-     #define STORE(array,reg,n,N) transpose8x8_intrinsic(reg); store(array,reg,n,N);
-  #elif FPPREC == 1
-     #define LOAD(reg,array,n,N) load(reg,array,n,N); transpose4x4_intrinsic(reg); 
-     #define STORE(array,reg,n,N) transpose4x4_intrinsic(reg); store(array,reg,n,N);
-  #endif
-#endif
+template<typename REAL>
+inline void store_inc(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+  __assume_aligned(src,SIMD_WIDTH);
+  __assume_aligned(dst,SIMD_WIDTH);
+  for(int i=0; i<SIMD_VEC; i++) {
+    *(SIMD_REG*)&(dst[i*pad+n]) = simd_traits<REAL>::add(*(SIMD_REG*)&(dst[i*pad+n]), src[i]);
+  }
+}
+
+template<typename REAL>
+inline void store_stream(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad) {
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int i=0; i<SIMD_VEC; i++) {
+    simd_traits<REAL>::stream(&dst[i*pad+n], src[i]);
+  }
+}
+
+// As load(), store(), store_inc() and store_stream() for only the first rows of the SIMD_VEC rows: the registers of
+// the other rows are filled from fill and not stored
+template<typename REAL>
+inline void load(typename simd_traits<REAL>::reg * __restrict__ dst, const REAL * __restrict__ src, int n, int pad, int rows, typename simd_traits<REAL>::reg fill) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int i=0; i<SIMD_VEC; i++) {
+    dst[i] = (i < rows) ? *(SIMD_REG*)&(src[i*pad+n]) : fill;
+  }
+}
+
+template<typename REAL>
+inline void store(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad, int rows) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int i=0; i<SIMD_VEC; i++) {
+    if(i < rows) *(SIMD_REG*)&(dst[i*pad+n]) = src[i];
+  }
+}
+
+template<typename REAL>
+inline void store_inc(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad, int rows) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int i=0; i<SIMD_VEC; i++) {
+    if(i < rows) *(SIMD_REG*)&(dst[i*pad+n]) = simd_traits<REAL>::add(*(SIMD_REG*)&(dst[i*pad+n]), src[i]);
+  }
+}
+
+template<typename REAL>
+inline void store_stream(REAL * __restrict__ dst, typename simd_traits<REAL>::reg * __restrict__ src, int n, int pad, int rows) {
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int i=0; i<SIMD_VEC; i++) {
+    if(i < rows) simd_traits<REAL>::stream(&dst[i*pad+n], src[i]);
+  }
+}
+
+// Load/store SIMD_VEC rows and transpose them in registers, so that every register holds one element of SIMD_VEC
+// different systems
+#define LOAD(reg,array,n,N) load(reg,array,n,N); simd_traits<REAL>::transpose(reg);
+#define STORE(array,reg,n,N) simd_traits<REAL>::transpose(reg); store(array,reg,n,N);
+#define STORE_INC(array,reg,n,N) simd_traits<REAL>::transpose(reg); store_inc(array,reg,n,N);
+#define STORE_STREAM(array,reg,n,N) simd_traits<REAL>::transpose(reg); store_stream(array,reg,n,N);
+// The same for the first R rows only
+#define LOAD_ROWS(reg,array,n,N,R,fill) load(reg,array,n,N,R,fill); simd_traits<REAL>::transpose(reg);
+#define STORE_ROWS(array,reg,n,N,R) simd_traits<REAL>::transpose(reg); store(array,reg,n,N,R);
+#define STORE_INC_ROWS(array,reg,n,N,R) simd_traits<REAL>::transpose(reg); store_inc(array,reg,n,N,R);
+#define STORE_STREAM_ROWS(array,reg,n,N,R) simd_traits<REAL>::transpose(reg); store_stream(array,reg,n,N,R);
 
 //
 // tridiagonal-x solver
 //
 //__attribute__((vector(linear(a),linear(b),linear(c),linear(d),linear(u))))
 //inline void trid_x_transpose(FP* __restrict a, FP* __restrict b, FP* __restrict c, FP* __restrict d, FP* __restrict u, int sys_size, int sys_pad, int stride) {
-void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP* __restrict c, FP* __restrict d, FP* __restrict u, int sys_size, int sys_pad, int stride) {
+// c2 and d2 are workspaces of sys_size registers for the modified coefficients of the forward pass. With STREAM the
+// solution is written to d with non-temporal stores, which the caller orders with an sfence. With TAIL only the first
+// rows of the SIMD_VEC rows are systems, the others are solved as identity rows (a = c = d = 0, b = 1) and not stored.
+template<typename REAL, int INC, int STREAM, int TAIL>
+void trid_x_transpose(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int sys_size, int sys_pad, int stride, int rows, typename simd_traits<REAL>::reg* __restrict c2, typename simd_traits<REAL>::reg* __restrict d2) {
+  typedef simd_traits<REAL> simd;
+  typedef typename simd::reg SIMD_REG;
+  const int SIMD_WIDTH = simd::width;
+  const int SIMD_VEC   = simd::vec;
 
   __assume_aligned(a,SIMD_WIDTH);
   __assume_aligned(b,SIMD_WIDTH);
@@ -112,6 +211,10 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
 
   assert( (((long long)a)%SIMD_WIDTH) == 0);
 
+  const int      nrow = TAIL ? rows : SIMD_VEC; // Constant without TAIL, so the loads and stores stay unrolled
+  const SIMD_REG zero = simd::set1(0);
+  const SIMD_REG one  = simd::set1(1);
+
   int   i, ind = 0;
   SIMD_REG aa;  
   SIMD_REG bb;
@@ -128,30 +231,22 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
 
   SIMD_REG tmp_reg[SIMD_VEC];
 
-  SIMD_REG c2[N_MAX];
-  SIMD_REG d2[N_MAX];
-
   //
   // forward pass
   //
   int   n = 0;
-  SIMD_REG ones = SIMD_SET1_P(1.0F);
 
-  LOAD(a_reg,a,n,sys_pad);
-  LOAD(b_reg,b,n,sys_pad);
-  LOAD(c_reg,c,n,sys_pad);
-  LOAD(d_reg,d,n,sys_pad);
+  LOAD_ROWS(a_reg,a,n,sys_pad,nrow,zero);
+  LOAD_ROWS(b_reg,b,n,sys_pad,nrow,one);
+  LOAD_ROWS(c_reg,c,n,sys_pad,nrow,zero);
+  LOAD_ROWS(d_reg,d,n,sys_pad,nrow,zero);
 
   bb = b_reg[0];
-  #if FPPREC == 0
-    bb = SIMD_RCP_P(bb);
-  #elif FPPREC == 1
-    bb = SIMD_DIV_P(ones,bb);
-  #endif
+  bb = simd::rcp(bb);
   cc = c_reg[0];
-  cc = SIMD_MUL_P(bb,cc);
+  cc = simd::mul(bb,cc);
   dd = d_reg[0];
-  dd = SIMD_MUL_P(bb,dd);
+  dd = simd::mul(bb,dd);
   c2[0] = cc;
   d2[0] = dd;
   
@@ -159,20 +254,11 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
 
   for(i=1; i<SIMD_VEC; i++) {
     aa    = a_reg[i];
-    #ifdef __MIC__
-      bb    = SIMD_FNMADD_P(aa,cc,b_reg[i]);
-      dd    = SIMD_FNMADD_P(aa,dd,d_reg[i]);
-    #else
-      bb    = SIMD_SUB_P(b_reg[i], SIMD_MUL_P(aa,cc) );
-      dd    = SIMD_SUB_P(d_reg[i], SIMD_MUL_P(aa,dd) );
-    #endif
-    #if FPPREC == 0
-      bb    = SIMD_RCP_P(bb);
-    #elif FPPREC == 1
-      bb    = SIMD_DIV_P(ones,bb);
-    #endif
-    cc    = SIMD_MUL_P(bb,c_reg[i]);
-    dd    = SIMD_MUL_P(bb,dd);
+    bb    = simd::fnmadd(aa,cc,b_reg[i]);
+    dd    = simd::fnmadd(aa,dd,d_reg[i]);
+    bb    = simd::rcp(bb);
+    cc    = simd::mul(bb,c_reg[i]);
+    dd    = simd::mul(bb,dd);
     c2[n+i] = cc;
     d2[n+i] = dd;
 
@@ -181,26 +267,17 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
   //STORE(u,d_reg,n,sys_pad);
 
   for(n=SIMD_VEC; n < (sys_size/SIMD_VEC)*SIMD_VEC; n+=SIMD_VEC) {
-    LOAD(a_reg,a,n,sys_pad);
-    LOAD(b_reg,b,n,sys_pad);
-    LOAD(c_reg,c,n,sys_pad);
-    LOAD(d_reg,d,n,sys_pad);
+    LOAD_ROWS(a_reg,a,n,sys_pad,nrow,zero);
+    LOAD_ROWS(b_reg,b,n,sys_pad,nrow,one);
+    LOAD_ROWS(c_reg,c,n,sys_pad,nrow,zero);
+    LOAD_ROWS(d_reg,d,n,sys_pad,nrow,zero);
     for(i=0; i<SIMD_VEC; i++) {
       aa    = a_reg[i];
-      #ifdef __MIC__
-        bb    = SIMD_FNMADD_P(aa,cc,b_reg[i]);
-        dd    = SIMD_FNMADD_P(aa,dd,d_reg[i]);
-      #else
-        bb    = SIMD_SUB_P(b_reg[i], SIMD_MUL_P(aa,cc) );
-        dd    = SIMD_SUB_P(d_reg[i], SIMD_MUL_P(aa,dd) );
-      #endif
-      #if FPPREC == 0
-        bb    = SIMD_RCP_P(bb);
-      #elif FPPREC == 1
-        bb    = SIMD_DIV_P(ones,bb);
-      #endif
-      cc    = SIMD_MUL_P(bb,c_reg[i]);
-      dd    = SIMD_MUL_P(bb,dd);
+    bb    = simd::fnmadd(aa,cc,b_reg[i]);
+    dd    = simd::fnmadd(aa,dd,d_reg[i]);
+    bb    = simd::rcp(bb);
+      cc    = simd::mul(bb,c_reg[i]);
+      dd    = simd::mul(bb,dd);
       c2[n+i] = cc;
       d2[n+i] = dd;
       
@@ -213,7 +290,7 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
     //STORE(u,d_reg,n,sys_pad);
   }
 
-  if(sys_size != sys_pad) {
+  if((sys_size % SIMD_VEC) != 0) { // Last block is only partially filled
     //n=n-SIMD_VEC;
     n  = (sys_size/SIMD_VEC)*SIMD_VEC;
     //printf("n = %d\n",n);
@@ -223,28 +300,19 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
     //STORE(u,tmp_reg,n,sys_pad);
     //d_reg[0] = c2[n+0];//cc;//bb;//cc;//dd;
     //STORE(u,d_reg,n,sys_pad);
-    LOAD(a_reg,a,n,sys_pad);
-    LOAD(b_reg,b,n,sys_pad);
-    LOAD(c_reg,c,n,sys_pad);
-    LOAD(d_reg,d,n,sys_pad);
+    LOAD_ROWS(a_reg,a,n,sys_pad,nrow,zero);
+    LOAD_ROWS(b_reg,b,n,sys_pad,nrow,one);
+    LOAD_ROWS(c_reg,c,n,sys_pad,nrow,zero);
+    LOAD_ROWS(d_reg,d,n,sys_pad,nrow,zero);
     for(i=0; (n+i) < sys_size; i++) {
       //d_reg[i] = c2[n+i];//cc;//bb;//cc;//dd;
       //STORE(u,d_reg,n,sys_pad);
       aa    = a_reg[i];
-      #ifdef __MIC__
-        bb    = SIMD_FNMADD_P(aa,cc,b_reg[i]);
-        dd    = SIMD_FNMADD_P(aa,dd,d_reg[i]);
-      #else
-        bb    = SIMD_SUB_P(b_reg[i], SIMD_MUL_P(aa,cc) );
-        dd    = SIMD_SUB_P(d_reg[i], SIMD_MUL_P(aa,dd) );
-      #endif
-      #if FPPREC == 0
-        bb    = SIMD_RCP_P(bb);
-      #elif FPPREC == 1
-        bb    = SIMD_DIV_P(ones,bb);
-      #endif
-      cc    = SIMD_MUL_P(bb,c_reg[i]);
-      dd    = SIMD_MUL_P(bb,dd);
+    bb    = simd::fnmadd(aa,cc,b_reg[i]);
+    dd    = simd::fnmadd(aa,dd,d_reg[i]);
+    bb    = simd::rcp(bb);
+      cc    = simd::mul(bb,c_reg[i]);
+      dd    = simd::mul(bb,dd);
       c2[n+i] = cc;
       d2[n+i] = dd;
       
@@ -260,14 +328,21 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
       //for(i=sys_off-2; i>=0; i--) {
       //if(i==VEC-sys_off-1) l_d[i] = dd;
       //if(i<VEC-sys_off-1) {
-      dd     = SIMD_SUB_P(d2[n+i], SIMD_MUL_P(c2[n+i],dd) );
+      dd     = simd::sub(d2[n+i], simd::mul(c2[n+i],dd) );
 //    printf("i = %d   dd[0-15] = %f %f %f %f %f %f %f %f %f %f %f %f %f %f %f %f \n",i,((FP*)&dd)[0],((FP*)&dd)[1],((FP*)&dd)[2],((FP*)&dd)[3],((FP*)&dd)[4],((FP*)&dd)[5],((FP*)&dd)[6],((FP*)&dd)[7],((FP*)&dd)[8],((FP*)&dd)[9],((FP*)&dd)[10],((FP*)&dd)[11],((FP*)&dd)[12],((FP*)&dd)[13],((FP*)&dd)[14],((FP*)&dd)[15]);
       //  dd      = d2[n+i] - c2[n+i]*dd;
       d_reg[i] = dd;
       //l_d[i]  = n+i;
       //}
     }
-    STORE(d,d_reg,n,sys_pad);
+    if(INC) {
+      for(i=sys_size-n; i<SIMD_VEC; i++) d_reg[i] = zero; // Leave the padding of u unchanged
+      STORE_INC_ROWS(u,d_reg,n,sys_pad,nrow);
+    } else if(STREAM) {
+      STORE_STREAM_ROWS(d,d_reg,n,sys_pad,nrow);
+    } else {
+      STORE_ROWS(d,d_reg,n,sys_pad,nrow);
+    }
     //STORE(u,d_reg,n,sys_pad);
   } else {
 
@@ -282,39 +357,105 @@ void trid_x_transpose(const FP* __restrict a, const FP* __restrict b, const FP*
       //for(i=sys_off-2; i>=0; i--) {
       //if(i==VEC-sys_off-1) l_d[i] = dd;
       //if(i<VEC-sys_off-1) {
-      dd     = SIMD_SUB_P(d2[n+i], SIMD_MUL_P(c2[n+i],dd) );
+      dd     = simd::sub(d2[n+i], simd::mul(c2[n+i],dd) );
       //  dd      = d2[n+i] - c2[n+i]*dd;
       d_reg[i] = dd;
       //l_d[i]  = n+i;
       //}
     }
     //STORE(u,d_reg,n,sys_pad);
-    STORE(d,d_reg,n,sys_pad);
+    if(INC) {
+      STORE_INC_ROWS(u,d_reg,n,sys_pad,nrow);
+    } else if(STREAM) {
+      STORE_STREAM_ROWS(d,d_reg,n,sys_pad,nrow);
+    } else {
+      STORE_ROWS(d,d_reg,n,sys_pad,nrow);
+    }
   }
 
   //for(n=sys_size-2*VEC; n>=0; n-=VEC) {
-  //for(n=n-SIMD_VEC; n>=0; n-=SIMD_VEC) {
-  for(n=(sys_size/SIMD_VEC)*SIMD_VEC - SIMD_VEC; n>=0; n-=SIMD_VEC) {
+  //for(n=(sys_size/SIMD_VEC)*SIMD_VEC - SIMD_VEC; n>=0; n-=SIMD_VEC) {
+  // Continue from the block preceding the one stored above
+  for(n=n-SIMD_VEC; n>=0; n-=SIMD_VEC) {
     for(i=(SIMD_VEC-1); i>=0; i--) {
-      dd     = SIMD_SUB_P(d2[n+i], SIMD_MUL_P(c2[n+i],dd) );
+      dd     = simd::sub(d2[n+i], simd::mul(c2[n+i],dd) );
       //dd     = d2[n+i] - c2[n+i]*dd;
       d_reg[i] = dd;
       //l_d[i] = n+i;
     }
     //STORE(u,d_reg,n,sys_pad);
-    STORE(d,d_reg,n,sys_pad);
+    if(INC) {
+      STORE_INC_ROWS(u,d_reg,n,sys_pad,nrow);
+    } else if(STREAM) {
+      STORE_STREAM_ROWS(d,d_reg,n,sys_pad,nrow);
+    } else {
+      STORE_ROWS(d,d_reg,n,sys_pad,nrow);
+    }
+  }
+}
+
+#ifdef TRID_SIMD_MASK
+//
+// SIMD_VEC systems as in trid_scalar_vec(), of which only the first n lanes are loaded and stored, with unaligned masked
+// loads and stores. The other lanes solve identity rows. Systems along the lanes that don't fill a vector, and those of
+// arrays that aren't aligned, are solved at vector speed this way. stride is in elements.
+//
+template<typename REAL, int INC>
+void trid_scalar_vec_masked(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int N, long stride, int n, typename simd_traits<REAL>::vector* __restrict c2, typename simd_traits<REAL>::vector* __restrict d2) {
+  typedef simd_traits<REAL> simd;
+  typedef typename simd::vector VECTOR;
+  typedef typename simd::reg    SIMD_REG;
+  const typename simd::mask m = simd::first(n);
+  const SIMD_REG zero = simd::set1(0);
+  const SIMD_REG one  = simd::set1(1);
+
+  int    i;
+  long   ind = 0;
+  VECTOR aa, bb, cc, dd;
+  VECTOR ones(1.0f);
+  //
+  // forward pass
+  //
+  bb    = ones / VECTOR(simd::maskload(&b[0], m, one));
+  cc    = bb * VECTOR(simd::maskload(&c[0], m, zero));
+  dd    = bb * VECTOR(simd::maskload(&d[0], m, zero));
+  c2[0] = cc;
+  d2[0] = dd;
+  for(i=1; i<N; i++) {
+    ind   = ind + stride;
+    aa    = simd::maskload(&a[ind], m, zero);
+    bb    = VECTOR(simd::maskload(&b[ind], m, one)) - aa*cc;
+    dd    = VECTOR(simd::maskload(&d[ind], m, zero)) - aa*dd;
+    bb    = ones / bb;
+    cc    = bb * VECTOR(simd::maskload(&c[ind], m, zero));
+    dd    = bb * dd;
+    c2[i] = cc;
+    d2[i] = dd;
+  }
+  //
+  // reverse pass
+  //
+  if(INC) simd::maskstore(&u[ind], m, simd::add(simd::maskload(&u[ind], m, zero), dd));
+  else    simd::maskstore(&d[ind], m, dd);
+  for(i=N-2; i>=0; i--) {
+    ind = ind - stride;
+    dd  = d2[i] - c2[i]*dd;
+    if(INC) simd::maskstore(&u[ind], m, simd::add(simd::maskload(&u[ind], m, zero), dd));
+    else    simd::maskstore(&d[ind], m, dd);
   }
 }
+#endif
 
 //
 // tridiagonal solver
 //
-template<typename REAL, typename VECTOR, int INC>
+// c2 and d2 are workspaces of N vectors for the modified coefficients of the forward pass. STREAM as in trid_x_transpose().
+template<typename REAL, typename VECTOR, int INC, int STREAM>
 //inline void trid_scalar_vec(REAL* __restrict h_a, REAL* __restrict h_b, REAL* __restrict h_c, REAL* __restrict h_d, REAL* __restrict h_u, int N, int stride) {
-void trid_scalar_vec(const REAL* __restrict h_a, const REAL* __restrict h_b, const REAL* __restrict h_c, REAL* __restrict h_d, REAL* __restrict h_u, int N, int stride) {
+void trid_scalar_vec(const REAL* __restrict h_a, const REAL* __restrict h_b, const REAL* __restrict h_c, REAL* __restrict h_d, REAL* __restrict h_u, int N, int stride, VECTOR* __restrict c2, VECTOR* __restrict d2) {
 
   int i, ind = 0;
-  VECTOR aa, bb, cc, dd, c2[N_MAX], d2[N_MAX];
+  VECTOR aa, bb, cc, dd;
 
   VECTOR* __restrict a = (VECTOR*) h_a;
   VECTOR* __restrict b = (VECTOR*) h_b;
@@ -354,12 +495,14 @@ void trid_scalar_vec(const REAL* __restrict h_a, const REAL* __restrict h_b, con
   // reverse pass
   //
   if(INC) u[ind] += dd;
+  else if(STREAM) simd_traits<REAL>::stream((REAL*)&d[ind], dd);
   else    d[ind]  = dd;
 //  u[ind] = dd;
   for(i=N-2; i>=0; i--) {
     ind    = ind - stride;
     dd     = d2[i] - c2[i]*dd;
     if(INC) u[ind] += dd;
+    else if(STREAM) simd_traits<REAL>::stream((REAL*)&d[ind], dd);
     else    d[ind]  = dd;
 //    u[ind] = ones;
   }
@@ -369,9 +512,11 @@ void trid_scalar_vec(const REAL* __restrict h_a, const REAL* __restrict h_b, con
 // tridiagonal solver
 //
 //inline void trid_scalar(FP* __restrict a, FP* __restrict b, FP* __restrict c, FP* __restrict d, FP* __restrict u, int N, int stride) {
-void trid_scalar(const FP* __restrict a, const FP* __restrict b, const FP* __restrict c, FP* __restrict d, FP* __restrict u, int N, int stride) {
+// c2 and d2 are workspaces of N elements for the modified coefficients of the forward pass
+template<typename REAL, int INC>
+void trid_scalar(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int N, int stride, REAL* __restrict c2, REAL* __restrict d2) {
   int   i, ind = 0;
-  FP aa, bb, cc, dd, c2[N_MAX], d2[N_MAX];
+  REAL aa, bb, cc, dd;
   //
   // forward pass
   //
@@ -397,222 +542,2879 @@ void trid_scalar(const FP* __restrict a, const FP* __restrict b, const FP* __res
   //
   // reverse pass
   //
-  d[ind] = dd;
+  if(INC) u[ind] += dd;
+  else    d[ind]  = dd;
 //  u[ind] = dd;
   for(i=N-2; i>=0; i--) {
     ind    = ind - stride;
     dd     = d2[i] - c2[i]*dd;
-    d[ind] = dd;
+    if(INC) u[ind] += dd;
+    else    d[ind]  = dd;
 //    u[ind] = dd;
   }
 }
 
 //
-// Function for selecting the proper setup for solve in a specific dimension
+// tridiagonal-x solver for SIMD_VEC systems with a compact workspace. The modified c and d of an element are stored
+// next to each other, so the reverse pass reads one stream: ws is a workspace of 2*sys_size registers. STREAM as in
+// trid_x_transpose().
 //
-void tridMultiDimBatchSolve(const FP* a, const FP* b, const FP* c, FP* d, FP* u, int ndim, int solvedim, int *dims, int *pads) {
-  //int sys_n = cumdims[ndim]/dims[solvedim]; // Number of systems to be solved
+template<typename REAL, int INC, int STREAM>
+void trid_x_transpose_compact(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int sys_size, int sys_pad, typename simd_traits<REAL>::reg* __restrict ws) {
+  typedef simd_traits<REAL> simd;
+  typedef typename simd::reg SIMD_REG;
+  const int SIMD_WIDTH = simd::width;
+  const int SIMD_VEC   = simd::vec;
 
-  if(solvedim == 0) {
-    int sys_stride = 1;       // Stride between the consecutive elements of a system
-    int sys_size   = dims[0]; // Size (length) of a system
-    int sys_pads   = pads[0]; // Padded sizes along each ndim number of dimensions
-    int sys_n_lin  = dims[1]*dims[2]; // = cumdims[solve] // Number of systems to be solved
-    
-    //if((sys_pads % SIMD_VEC) == 0) {
-      #pragma omp parallel for collapse(2)
-      for(int k=0; k<dims[2]; k++) {
-        for(int j=0; j<ROUND_DOWN(dims[1],SIMD_VEC); j+=SIMD_VEC) {
-          int ind = k*pads[0]*dims[1] + j*pads[0];
-          trid_x_transpose(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_pads, sys_stride);
-        }
-      }
-      if(ROUND_DOWN(dims[1],SIMD_VEC) < dims[1]) { // If there is leftover, fork threads an compute it
-        #pragma omp parallel for collapse(2)
-        for(int k=0; k<dims[2]; k++) {
-          for(int j=ROUND_DOWN(dims[0],SIMD_VEC); j<dims[0]; j++) {
-            int ind = k*pads[0]*dims[1] + j*pads[0];
-            trid_scalar(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_stride);
-          }
-        }
-      }
-    //}
-    //else {
-    //  #pragma omp parallel for collapse(2)
-    //  for(int k=0; k<dims[2]; k++) {
-    //    for(int j=dims[0],SIMD_VEC); j<dims[0]; j++) {
-    //      int ind = k*pads[0]*dims[1] + j*pads[0];
-    //      trid_scalar(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_stride);
-    //    }
-    //  }
-    //} 
-  }
-  //else if(solvedim==1) {
-  //  int sys_stride = dims[0]; // Stride between the consecutive elements of a system
-  //  int sys_size   = dims[1]; // Size (length) of a system
-  //  int sys_pads   = pads[1]; // Padded sizes along each ndim number of dimensions
-  //  int sys_n_lin  = dims[0]*dims[2]; // = cumdims[solve] // Number of systems to be solved
-  //
-  //  trid_scalar_vec<FP,VECTOR,0>(a, b, c, d, u, sys_size, sys_stride);
-
-  //} else if(solvedim==2) {
-  //  int numTrids = dims[0]*dims[1];
-  //  int length   = dims[2];
-  //  int stride1  = dims[0]*dims[1];
-  //  int stride2  = 1;
-  //  int subBatchSize   = dims[0]*dims[1];
-  //  int subBatchStride = 0;
-  //    solveBatchedTrid<REAL,INC>(numTrids, length, stride1, stride2, subBatchSize, subBatchStride, d_a, d_b, d_c, d_d, d_u);
-  //} else {
-  //  // Test if data is aligned
-  //  long isaligned = 0;
-  //  isaligned  = (long)d_a % CUDA_ALIGN_BYTE;            // Check if base pointers are aligned
-  //  isaligned += (long)d_b % CUDA_ALIGN_BYTE;
-  //  isaligned += (long)d_c % CUDA_ALIGN_BYTE;
-  //  isaligned += (long)d_d % CUDA_ALIGN_BYTE;
-  //  if(d_u != NULL) isaligned += (long)d_u % CUDA_ALIGN_BYTE;
-  //  isaligned += (dims[0]*sizeof(REAL)) % CUDA_ALIGN_BYTE; // Check if X-dimension allows alignment
-
-  //  if(isaligned==0) { // If any of the above is non-zero, vector loads can not be used
-  //    if(sizeof(REAL) == 4) {
-  //      // Kernel launch configuration
-  //      int sys_n_float4 = sys_n/4;
-  //      int blockdimx_float4 = 128; // Has to be the multiple of 32(or maybe 4??)
-  //      int blockdimy_float4 = 1;
-  //      int dimgrid_float4   = 1 + (sys_n_float4-1)/blockdimx_float4; // can go up to 65535
-  //      int dimgridx_float4  = dimgrid_float4 % 65536;         // can go up to max 65535 on Fermi
-  //      int dimgridy_float4  = 1 + dimgrid_float4 / 65536;
-  //      dim3 dimGrid_float4(dimgridx_float4, dimgridy_float4);
-  //      dim3 dimBlock_float4(blockdimx_float4,blockdimy_float4);
-
-  //      // Setup dimension and padding according to float4 loads/stores
-  //      dims[0] = dims[0]/4;
-  //      pads[0] = dims[0];
-  //      //trid_set_consts(ndim, dims, pads);
-  //      initTridMultiDimBatchSolve(ndim, dims, pads);
-
-  //      trid_strided_multidim<float,float4,INC><<<dimGrid_float4, dimBlock_float4>>>((float4*)d_a, (float4*)d_b, (float4*)d_c, (float4*)d_d, (float4*)d_u, ndim, solvedim, sys_n_float4);
-
-  //      dims[0] = dims[0]*4;
-  //      pads[0] = dims[0];
-  //      //trid_set_consts(ndim, dims, pads);
-  //      initTridMultiDimBatchSolve(ndim, dims, pads);
-  //    } else if(sizeof(REAL) == 8) {
-  //      // Kernel launch configuration
-  //      int sys_n_double2 = sys_n/2;
-  //      int blockdimx_double2 = 128; // Has to be the multiple of 32(or maybe 4??)
-  //      int blockdimy_double2 = 1;
-  //      int dimgrid_double2  = 1 + (sys_n_double2-1)/blockdimx_double2; // can go up to 65535
-  //      int dimgridx_double2  = dimgrid_double2 % 65536;         // can go up to max 65535 on Fermi
-  //      int dimgridy_double2  = 1 + dimgrid_double2 / 65536;
-  //      dim3 dimGrid_double2(dimgridx_double2, dimgridy_double2);
-  //      dim3 dimBlock_double2(blockdimx_double2,blockdimy_double2);
-  //      // Setup dimension and padding according to double2 loads/stores
-  //      dims[0] = dims[0]/2;
-  //      pads[0] = dims[0];
-  //      //trid_set_consts(ndim, dims, pads);
-  //      initTridMultiDimBatchSolve(ndim, dims, pads);
-
-  //      trid_strided_multidim<double,double2,INC><<<dimGrid_double2, dimBlock_double2>>>((double2*)d_a, (double2*)d_b, (double2*)d_c, (double2*)d_d, (double2*)d_u, ndim, solvedim, sys_n_double2);
-
-  //      dims[0] = dims[0]*2;
-  //      pads[0] = dims[0];
-  //      //trid_set_consts(ndim, dims, pads);
-  //      initTridMultiDimBatchSolve(ndim, dims, pads);
-  //    }
-  //  } else {
-  //    // Kernel launch configuration
-  //    int blockdimx = 128; // Has to be the multiple of 32(or maybe 4??)
-  //    int blockdimy = 1;
-  //    int dimgrid   = 1 + (sys_n-1)/blockdimx; // can go up to 65535
-  //    int dimgridx  = dimgrid % 65536;         // can go up to max 65535 on Fermi
-  //    int dimgridy  = 1 + dimgrid / 65536;
-  //    dim3 dimGrid(dimgridx, dimgridy);
-  //    dim3 dimBlock(blockdimx,blockdimy);
-
-  //    trid_strided_multidim<REAL,REAL,INC><<<dimGrid, dimBlock>>>(d_a, d_b, d_c, d_d, d_u, ndim, solvedim, sys_n);
-  //  }
-  //}
-  //}
-}
-
-
-#if FPPREC == 0
+  __assume_aligned(a,SIMD_WIDTH);
+  __assume_aligned(b,SIMD_WIDTH);
+  __assume_aligned(c,SIMD_WIDTH);
+  __assume_aligned(d,SIMD_WIDTH);
 
+  int      i, n, m;
+  SIMD_REG bb, cc, dd;
+  SIMD_REG a_reg[SIMD_VEC];
+  SIMD_REG b_reg[SIMD_VEC];
+  SIMD_REG c_reg[SIMD_VEC];
+  SIMD_REG d_reg[SIMD_VEC];
 
-tridStatus_t tridSmtsvStridedBatch(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
-  tridMultiDimBatchSolve(a, b, c, d, NULL, ndim, solvedim, dims, pads);
-  return TRID_STATUS_SUCCESS;
+  cc = simd::set1(0.0f);
+  dd = simd::set1(0.0f);
+  //
+  // forward pass
+  //
+  int nfull = (sys_size/SIMD_VEC)*SIMD_VEC;
+  for(n=0; n<nfull; n+=SIMD_VEC) {
+    LOAD(a_reg,a,n,sys_pad);
+    LOAD(b_reg,b,n,sys_pad);
+    LOAD(c_reg,c,n,sys_pad);
+    LOAD(d_reg,d,n,sys_pad);
+    if(n == 0) a_reg[0] = simd::set1(0.0f); // a of the first row is not part of the system
+    for(i=0; i<SIMD_VEC; i++) {
+      bb = simd::rcp(simd::fnmadd(a_reg[i],cc,b_reg[i]));
+      cc = simd::mul(bb,c_reg[i]);
+      dd = simd::mul(bb,simd::fnmadd(a_reg[i],dd,d_reg[i]));
+      ws[2*(n+i)  ] = cc;
+      ws[2*(n+i)+1] = dd;
+    }
+  }
+  m = sys_size - nfull;
+  if(m > 0) { // Last block is only partially filled
+    LOAD(a_reg,a,n,sys_pad);
+    LOAD(b_reg,b,n,sys_pad);
+    LOAD(c_reg,c,n,sys_pad);
+    LOAD(d_reg,d,n,sys_pad);
+    if(n == 0) a_reg[0] = simd::set1(0.0f);
+    for(i=0; i<m; i++) {
+      bb = simd::rcp(simd::fnmadd(a_reg[i],cc,b_reg[i]));
+      cc = simd::mul(bb,c_reg[i]);
+      dd = simd::mul(bb,simd::fnmadd(a_reg[i],dd,d_reg[i]));
+      ws[2*(n+i)  ] = cc;
+      ws[2*(n+i)+1] = dd;
+    }
+    //
+    // reverse pass of the partial block: elements beyond sys_size are stored back unchanged, or not added to u
+    //
+    if(INC) for(i=m; i<SIMD_VEC; i++) d_reg[i] = simd::set1(0.0f);
+    d_reg[m-1] = dd;
+    for(i=m-2; i>=0; i--) {
+      dd       = simd::fnmadd(ws[2*(n+i)],dd,ws[2*(n+i)+1]);
+      d_reg[i] = dd;
+    }
+    if(INC) {
+      STORE_INC(u,d_reg,n,sys_pad);
+    } else if(STREAM) {
+      STORE_STREAM(d,d_reg,n,sys_pad);
+    } else {
+      STORE(d,d_reg,n,sys_pad);
+    }
+  } else {
+    ws[2*(sys_size-1)] = simd::set1(0.0f); // Last row has no c
+  }
+  //
+  // reverse pass
+  //
+  for(n=nfull-SIMD_VEC; n>=0; n-=SIMD_VEC) {
+    for(i=SIMD_VEC-1; i>=0; i--) {
+      dd       = simd::fnmadd(ws[2*(n+i)],dd,ws[2*(n+i)+1]);
+      d_reg[i] = dd;
+    }
+    if(INC) {
+      STORE_INC(u,d_reg,n,sys_pad);
+    } else if(STREAM) {
+      STORE_STREAM(d,d_reg,n,sys_pad);
+    } else {
+      STORE(d,d_reg,n,sys_pad);
+    }
+  }
 }
 
-//tridStatus_t tridSmtsvStridedBatchInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int *opts, int sync) {
-//  tridMultiDimBatchSolve<float,1>(a, b, c, d, u, ndim, solvedim, dims, pads, opts, 1);
-//  return TRID_STATUS_SUCCESS;
-//}
-//
-//int* get_opts() {return opts;}
-
-
-
-
-
-void trid_scalarS(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int N, int stride) {
-  
-  trid_scalar(a, b, c, d, u, N, stride);
-  
+#ifdef TRID_SIMD_GATHER
+// Gather and scatter for trid_x_gather(), of the first lanes of m only with TAIL
+template<typename REAL, int TAIL>
+inline typename simd_traits<REAL>::reg trid_x_gather_rows(const REAL *p, typename simd_traits<REAL>::index lanes, typename simd_traits<REAL>::mask m, typename simd_traits<REAL>::reg fill) {
+  return TAIL ? simd_traits<REAL>::maskgather(p, lanes, m, fill) : simd_traits<REAL>::gather(p, lanes);
 }
 
-void trid_x_transposeS(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int sys_size, int sys_pad, int stride) {
-
-  trid_x_transpose(a, b, c, d, u, sys_size, sys_pad, stride);
-
+template<typename REAL, int TAIL>
+inline void trid_x_scatter_rows(REAL *p, typename simd_traits<REAL>::index lanes, typename simd_traits<REAL>::mask m, typename simd_traits<REAL>::reg r) {
+  if(TAIL) simd_traits<REAL>::maskscatter(p, lanes, m, r);
+  else     simd_traits<REAL>::scatter(p, lanes, r);
 }
 
-void trid_scalar_vecS(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int N, int stride) {
-
-  trid_scalar_vec<FP,VECTOR,0>(a, b, c, d, u, N, stride);
-
+//
+// tridiagonal-x solver for SIMD_VEC systems whose rows are loaded with gathers instead of register transposes, so the
+// rows need neither padding nor alignment. lanes holds the offsets of the systems, c2 and d2 are workspaces of N
+// registers. With TAIL only the first rows lanes hold systems: the others are gathered as identity rows
+// (a = c = d = 0, b = 1) and not scattered.
+//
+template<typename REAL, int INC, int TAIL>
+void trid_x_gather(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int N, typename simd_traits<REAL>::index lanes, int rows, typename simd_traits<REAL>::reg* __restrict c2, typename simd_traits<REAL>::reg* __restrict d2) {
+  typedef simd_traits<REAL> simd;
+  typedef typename simd::reg SIMD_REG;
+  const typename simd::mask m    = simd::first(TAIL ? rows : simd::vec);
+  const SIMD_REG            zero = simd::set1(0);
+  const SIMD_REG            one  = simd::set1(1);
+
+  int      i;
+  SIMD_REG aa, bb, cc, dd;
+  //
+  // forward pass
+  //
+  bb    = simd::rcp(trid_x_gather_rows<REAL,TAIL>(b,lanes,m,one));
+  cc    = simd::mul(bb,trid_x_gather_rows<REAL,TAIL>(c,lanes,m,zero));
+  dd    = simd::mul(bb,trid_x_gather_rows<REAL,TAIL>(d,lanes,m,zero));
+  c2[0] = cc;
+  d2[0] = dd;
+  for(i=1; i<N; i++) {
+    aa    = trid_x_gather_rows<REAL,TAIL>(&a[i],lanes,m,zero);
+    bb    = simd::rcp(simd::fnmadd(aa,cc,trid_x_gather_rows<REAL,TAIL>(&b[i],lanes,m,one)));
+    cc    = simd::mul(bb,trid_x_gather_rows<REAL,TAIL>(&c[i],lanes,m,zero));
+    dd    = simd::mul(bb,simd::fnmadd(aa,dd,trid_x_gather_rows<REAL,TAIL>(&d[i],lanes,m,zero)));
+    c2[i] = cc;
+    d2[i] = dd;
+  }
+  //
+  // reverse pass
+  //
+  for(i=N-1; i>=0; i--) {
+    if(i < N-1) dd = simd::fnmadd(c2[i],dd,d2[i]);
+    if(INC) trid_x_scatter_rows<REAL,TAIL>(&u[i], lanes, m, simd::add(trid_x_gather_rows<REAL,TAIL>(&u[i],lanes,m,zero),dd));
+    else    trid_x_scatter_rows<REAL,TAIL>(&d[i], lanes, m, dd);
+  }
 }
+#endif
 
-void trid_scalar_vecSInc(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int N, int stride) {
-
-  trid_scalar_vec<FP,VECTOR,1>(a, b, c, d, u, N, stride);
-
+//
+// Tridiagonal solver for NR right hand sides sharing the coefficients. The elimination is done once and applied to
+// every r.h.s., whose elements are rhs_stride apart. T is either REAL or a dvec class for SIMD_VEC systems.
+// c2 is a workspace of N elements, d2 of NR*N elements.
+//
+template<typename T, int INC, int NR>
+void trid_scalar_nrhs(const T* __restrict a, const T* __restrict b, const T* __restrict c, T* __restrict d, T* __restrict u, int N, long stride, long rhs_stride, T* __restrict c2, T* __restrict d2) {
+  int  i, r;
+  long ind = 0;
+  T    aa, bb, cc;
+  T    dd[NR];
+  T    ones(1.0f);
+  //
+  // forward pass
+  //
+  bb    = ones / b[0];
+  cc    = bb*c[0];
+  c2[0] = cc;
+  for(r=0; r<NR; r++) {
+    dd[r] = bb*d[r*rhs_stride];
+    d2[r] = dd[r];
+  }
+  for(i=1; i<N; i++) {
+    ind   = ind + stride;
+    aa    = a[ind];
+    bb    = ones / (b[ind] - aa*cc);
+    cc    = bb*c[ind];
+    c2[i] = cc;
+    for(r=0; r<NR; r++) {
+      dd[r]      = bb*(d[r*rhs_stride+ind] - aa*dd[r]);
+      d2[i*NR+r] = dd[r];
+    }
+  }
+  //
+  // reverse pass
+  //
+  for(r=0; r<NR; r++) {
+    if(INC) u[r*rhs_stride+ind] += dd[r];
+    else    d[r*rhs_stride+ind]  = dd[r];
+  }
+  for(i=N-2; i>=0; i--) {
+    ind = ind - stride;
+    cc  = c2[i];
+    for(r=0; r<NR; r++) {
+      dd[r] = d2[i*NR+r] - cc*dd[r];
+      if(INC) u[r*rhs_stride+ind] += dd[r];
+      else    d[r*rhs_stride+ind]  = dd[r];
+    }
+  }
 }
 
-#elif FPPREC == 1
-
-tridStatus_t tridDmtsvStridedBatch(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
-  tridMultiDimBatchSolve(a, b, c, d, NULL, ndim, solvedim, dims, pads);
-  return TRID_STATUS_SUCCESS;
+// Instantiate trid_scalar_nrhs() for the run time number of right hand sides nr <= NRHS_BLOCK
+template<typename T, int INC>
+void trid_scalar_nrhs(const T* a, const T* b, const T* c, T* d, T* u, int N, long stride, int nr, long rhs_stride, T* c2, T* d2) {
+  switch(nr) {
+    case 1:  trid_scalar_nrhs<T,INC,1>(a, b, c, d, u, N, stride, rhs_stride, c2, d2); break;
+    case 2:  trid_scalar_nrhs<T,INC,2>(a, b, c, d, u, N, stride, rhs_stride, c2, d2); break;
+    case 3:  trid_scalar_nrhs<T,INC,3>(a, b, c, d, u, N, stride, rhs_stride, c2, d2); break;
+    default: trid_scalar_nrhs<T,INC,4>(a, b, c, d, u, N, stride, rhs_stride, c2, d2); break;
+  }
 }
 
-void trid_scalarD(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int N, int stride) {
-  
-  trid_scalar(a, b, c, d, u, N, stride);
+//
+// Solve SIMD_VEC x-systems for nr <= NRHS_BLOCK right hand sides sharing the coefficients. The coefficients are loaded
+// and transposed once per block of SIMD_VEC elements, only the blocks of d are loaded for every r.h.s.
+// c2 is a workspace of sys_size registers, d2 of nr*sys_size registers.
+//
+template<typename REAL, int INC>
+void trid_x_transpose_nrhs(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int sys_size, int sys_pad, int nr, long rhs_stride, typename simd_traits<REAL>::reg* __restrict c2, typename simd_traits<REAL>::reg* __restrict d2) {
+  typedef simd_traits<REAL> simd;
+  typedef typename simd::reg SIMD_REG;
+  const int SIMD_WIDTH = simd::width;
+  const int SIMD_VEC   = simd::vec;
 
-}
+  __assume_aligned(a,SIMD_WIDTH);
+  __assume_aligned(b,SIMD_WIDTH);
+  __assume_aligned(c,SIMD_WIDTH);
+  __assume_aligned(d,SIMD_WIDTH);
 
-void trid_x_transposeD(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int sys_size, int sys_pad, int stride) {
+  int      i, n, m, r;
+  SIMD_REG cc = simd::set1(0.0f);
+  SIMD_REG dd[NRHS_BLOCK];
+  SIMD_REG a_reg[SIMD_VEC];
+  SIMD_REG b_reg[SIMD_VEC];
+  SIMD_REG c_reg[SIMD_VEC];
+  SIMD_REG d_reg[SIMD_VEC];
 
-  trid_x_transpose(a, b, c, d, u, sys_size, sys_pad, stride);
+  for(r=0; r<nr; r++) dd[r] = simd::set1(0.0f);
 
+  //
+  // forward pass
+  //
+  for(n=0; n<sys_size; n+=SIMD_VEC) {
+    LOAD(a_reg,a,n,sys_pad);
+    LOAD(b_reg,b,n,sys_pad);
+    LOAD(c_reg,c,n,sys_pad);
+    if(n == 0) a_reg[0] = simd::set1(0.0f); // a of the first row is not part of the system
+    m = (sys_size-n < SIMD_VEC) ? sys_size-n : SIMD_VEC;
+    for(i=0; i<m; i++) {
+      b_reg[i] = simd::rcp(simd::fnmadd(a_reg[i],cc,b_reg[i]));
+      cc       = simd::mul(b_reg[i],c_reg[i]);
+      c2[n+i]  = cc;
+    }
+    for(r=0; r<nr; r++) {
+      LOAD(d_reg,&d[r*rhs_stride],n,sys_pad);
+      for(i=0; i<m; i++) {
+        dd[r]              = simd::mul(b_reg[i], simd::fnmadd(a_reg[i],dd[r],d_reg[i]));
+        d2[r*sys_size+n+i] = dd[r];
+      }
+    }
+  }
+  //
+  // reverse pass
+  //
+  n -= SIMD_VEC;
+  c2[sys_size-1] = simd::set1(0.0f); // Start the recurrence of every r.h.s. from zero
+  for(r=0; r<nr; r++) {
+    REAL     *dr = &d[r*rhs_stride];
+    REAL     *ur = &u[r*rhs_stride];
+    SIMD_REG  x  = simd::set1(0.0f);
+    // Elements of the last block beyond sys_size are stored back unchanged, or not added to u
+    if(INC) {
+      for(i=0; i<SIMD_VEC; i++) d_reg[i] = simd::set1(0.0f);
+    } else {
+      LOAD(d_reg,dr,n,sys_pad);
+    }
+    for(int k=n; k>=0; k-=SIMD_VEC) {
+      m = (sys_size-k < SIMD_VEC) ? sys_size-k : SIMD_VEC;
+      for(i=m-1; i>=0; i--) {
+        x        = simd::fnmadd(c2[k+i],x,d2[r*sys_size+k+i]);
+        d_reg[i] = x;
+      }
+      if(INC) {
+        STORE_INC(ur,d_reg,k,sys_pad);
+      } else {
+        STORE(dr,d_reg,k,sys_pad);
+      }
+    }
+  }
 }
 
-void trid_scalar_vecD(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int N, int stride) {
-
-  trid_scalar_vec<FP,VECTOR,0>(a, b, c, d, u, N, stride);
-
+//
+// LU factorization of a tridiagonal system for repeated solves with the same coefficients. Stores the reciprocal of
+// the pivots 1/b', the lower diagonal scaled by them a/b' and the modified upper diagonal c' = c/b'. The first element
+// of a/b' and the last one of c' are zeroed, so both recurrences of the solve start from zero. T is either REAL or a
+// dvec class for SIMD_VEC systems. The factors may be stored with a different stride than the coefficients.
+//
+template<typename T>
+void trid_factor(const T* __restrict a, const T* __restrict b, const T* __restrict c, long stride, T* __restrict rb, T* __restrict ra, T* __restrict rc, long fstride, int N) {
+  int  i;
+  long ind = 0, find = 0;
+  T    bb, cc;
+  T    ones(1.0f);
+  T    zero(0.0f);
+
+  bb     = ones / b[0];
+  cc     = bb*c[0];
+  rb[0]  = bb;
+  ra[0]  = zero;
+  rc[0]  = cc;
+  for(i=1; i<N; i++) {
+    ind      = ind  + stride;
+    find     = find + fstride;
+    bb       = ones / (b[ind] - a[ind]*cc);
+    cc       = bb*c[ind];
+    rb[find] = bb;
+    ra[find] = bb*a[ind];
+    rc[find] = cc;
+  }
+  rc[find] = zero;
 }
 
-void trid_scalar_vecDInc(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int N, int stride) {
+//
+// Factorization of a Toeplitz system: constant a, b and c in the interior rows, the first row is (b0, c0) and the last
+// one (an, bn). The pivots depend only on the position in the system, so one sequence of factors serves every system
+// of a batch. Same factors as in trid_factor().
+//
+template<typename REAL>
+void trid_factor_toeplitz(REAL a, REAL b, REAL c, REAL b0, REAL c0, REAL an, REAL bn, REAL* __restrict rb, REAL* __restrict ra, REAL* __restrict rc, int N) {
+  int  i;
+  REAL bb, cc;
+
+  bb    = 1.0F/b0;
+  cc    = bb*c0;
+  rb[0] = bb;
+  ra[0] = 0.0F;
+  rc[0] = cc;
+  for(i=1; i<N-1; i++) {
+    bb    = 1.0F/(b - a*cc);
+    cc    = bb*c;
+    rb[i] = bb;
+    ra[i] = bb*a;
+    rc[i] = cc;
+  }
+  if(N > 1) {
+    bb    = 1.0F/(bn - an*cc);
+    rb[i] = bb;
+    ra[i] = bb*an;
+  }
+  rc[N-1] = 0.0F;
+}
 
-  trid_scalar_vec<FP,VECTOR,1>(a, b, c, d, u, N, stride);
+//
+// Solve with the factors of trid_factor(): only d is read from memory besides the factors, and there is no division.
+// The factors F are either of the type T of d, or scalars broadcast to it for the Toeplitz factors of
+// trid_factor_toeplitz(). d2 is a workspace of N elements.
+//
+template<typename F, typename T, int INC>
+void trid_solve_factored(const F* __restrict rb, const F* __restrict ra, const F* __restrict rc, long fstride, T* __restrict d, T* __restrict u, long stride, int N, T* __restrict d2) {
+  int  i;
+  long ind = 0, find = 0;
+  T    dd;
+  //
+  // forward pass
+  //
+  dd    = T(rb[0])*d[0];
+  d2[0] = dd;
+  for(i=1; i<N; i++) {
+    ind   = ind  + stride;
+    find  = find + fstride;
+    dd    = T(rb[find])*d[ind] - T(ra[find])*dd;
+    d2[i] = dd;
+  }
+  //
+  // reverse pass
+  //
+  if(INC) u[ind] += dd;
+  else    d[ind]  = dd;
+  for(i=N-2; i>=0; i--) {
+    ind    = ind  - stride;
+    find   = find - fstride;
+    dd     = d2[i] - T(rc[find])*dd;
+    if(INC) u[ind] += dd;
+    else    d[ind]  = dd;
+  }
+}
 
+//
+// Factor of the i-th row element of SIMD_VEC x-systems: batch factors are interleaved, one register per row element,
+// while Toeplitz factors are scalars shared by every system
+//
+template<typename REAL, int TOEPLITZ>
+inline typename simd_traits<REAL>::reg factor_reg(const REAL* __restrict f, int i) {
+  if(TOEPLITZ) return simd_traits<REAL>::set1(f[i]);
+  else         return ((const typename simd_traits<REAL>::reg*)f)[i];
 }
-#endif
 
+//
+// Solve SIMD_VEC x-systems with the factors of trid_factor() or trid_factor_toeplitz(). Only d has to be transposed.
+//
+template<typename REAL, int TOEPLITZ, int INC>
+void trid_x_transpose_factored(const REAL* __restrict rb, const REAL* __restrict ra, const REAL* __restrict rc, REAL* __restrict d, REAL* __restrict u, int sys_size, int sys_pad, typename simd_traits<REAL>::reg* __restrict d2) {
+  typedef simd_traits<REAL> simd;
+  typedef typename simd::reg SIMD_REG;
+  const int SIMD_WIDTH = simd::width;
+  const int SIMD_VEC   = simd::vec;
 
+  __assume_aligned(d,SIMD_WIDTH);
 
+  int      i, n, m;
+  SIMD_REG dd = simd::set1(0.0f);
+  SIMD_REG d_reg[SIMD_VEC];
 
+  //
+  // forward pass
+  //
+  for(n=0; n<sys_size; n+=SIMD_VEC) {
+    LOAD(d_reg,d,n,sys_pad);
+    m = (sys_size-n < SIMD_VEC) ? sys_size-n : SIMD_VEC;
+    for(i=0; i<m; i++) {
+      dd      = simd::fnmadd(factor_reg<REAL,TOEPLITZ>(ra,n+i), dd, simd::mul(factor_reg<REAL,TOEPLITZ>(rb,n+i), d_reg[i]));
+      d2[n+i] = dd;
+    }
+  }
+  //
+  // reverse pass
+  //
+  // d_reg still holds the last block: elements beyond sys_size are stored back unchanged, or not added to u
+  n -= SIMD_VEC;
+  if(INC) for(i=sys_size-n; i<SIMD_VEC; i++) d_reg[i] = simd::set1(0.0f);
+  dd = simd::set1(0.0f);
+  for(; n>=0; n-=SIMD_VEC) {
+    m = (sys_size-n < SIMD_VEC) ? sys_size-n : SIMD_VEC;
+    for(i=m-1; i>=0; i--) {
+      dd       = simd::fnmadd(factor_reg<REAL,TOEPLITZ>(rc,n+i), dd, d2[n+i]);
+      d_reg[i] = dd;
+    }
+    if(INC) {
+      STORE_INC(u,d_reg,n,sys_pad);
+    } else {
+      STORE(d,d_reg,n,sys_pad);
+    }
+  }
+}
+
+//
+// Test if vector loads/stores can be used on the arrays: base pointers have to be aligned and the padding along the
+// x dimension has to keep every row aligned
+//
+template<typename REAL>
+inline int is_simd_aligned(const REAL* a, const REAL* b, const REAL* c, const REAL* d, const REAL* u, int pad) {
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+  long isaligned = 0;
+  isaligned  = (long)a % SIMD_WIDTH; // Check if base pointers are aligned
+  isaligned += (long)b % SIMD_WIDTH;
+  isaligned += (long)c % SIMD_WIDTH;
+  isaligned += (long)d % SIMD_WIDTH;
+  if(u != NULL) isaligned += (long)u % SIMD_WIDTH;
+  isaligned += pad % SIMD_VEC;       // Check if X-dimension padding allows alignment
+  return isaligned == 0;
+}
+
+//
+// Offset of the first system row with the outer index k. The outer index runs through every dimension except the
+// solved dimension and the one mapped onto the SIMD lanes.
+//
+inline long outer_offset(long k, int ndim, int solvedim, int lanedim, const int *dims, const long *cumpads) {
+  long ind = 0;
+  for(int i=0; i<ndim; i++) {
+    if(i == solvedim || i == lanedim) continue;
+    ind += (k % dims[i]) * cumpads[i];
+    k   /= dims[i];
+  }
+  return ind;
+}
+
+//
+// Periodic (cyclic) tridiagonal solver: a[0] couples the first row to x[N-1] and c[N-1] the last row to x[0]. With the
+// Sherman-Morrison formula the system is a tridiagonal one with modified first and last diagonal elements plus a rank
+// one correction. The r.h.s. d and the correction vector share the elimination, so both are solved in one forward and
+// one backward sweep over the workspace and the solution is written in a third one, reading a, b, c and d once.
+// T is either REAL or a dvec class for SIMD_VEC systems. c2, d2 and z2 are workspaces of N >= 2 elements.
+//
+template<typename T, int INC>
+void trid_cyclic(const T* __restrict a, const T* __restrict b, const T* __restrict c, T* __restrict d, T* __restrict u, int N, long stride, T* __restrict c2, T* __restrict d2, T* __restrict z2) {
+  int  i;
+  long ind  = 0;
+  long last = (N-1)*stride;
+  T    aa, bb, cc, dd, zz, f;
+  T    ones(1.0f);
+  T    zero(0.0f);
+  T    gamma = zero - b[0];   // Sherman-Morrison splitting, keeps the modified b[0] away from zero
+  T    alpha = a[0];          // Corner element of the first row
+  T    beta  = c[last];       // Corner element of the last row
+  T    ag    = alpha / gamma;
+  //
+  // forward pass of the r.h.s. d and of the correction vector z = (gamma, 0, ..., 0, beta)
+  //
+  bb    = ones / (b[0] - gamma);
+  cc    = bb*c[0];
+  dd    = bb*d[0];
+  zz    = bb*gamma;
+  c2[0] = cc;
+  d2[0] = dd;
+  z2[0] = zz;
+  for(i=1; i<N-1; i++) {
+    ind   = ind + stride;
+    aa    = a[ind];
+    bb    = ones / (b[ind] - aa*cc);
+    cc    = bb*c[ind];
+    dd    = bb*(d[ind] - aa*dd);
+    zz    = bb*(zero - aa*zz);
+    c2[i] = cc;
+    d2[i] = dd;
+    z2[i] = zz;
+  }
+  aa      = a[last];
+  bb      = ones / (b[last] - beta*ag - aa*cc);
+  d2[N-1] = bb*(d[last] - aa*dd);
+  z2[N-1] = bb*(beta - aa*zz);
+  //
+  // reverse pass
+  //
+  for(i=N-2; i>=0; i--) {
+    d2[i] = d2[i] - c2[i]*d2[i+1];
+    z2[i] = z2[i] - c2[i]*z2[i+1];
+  }
+  //
+  // correction
+  //
+  f   = (d2[0] + ag*d2[N-1]) / (ones + z2[0] + ag*z2[N-1]);
+  ind = 0;
+  for(i=0; i<N; i++) {
+    if(INC) u[ind] += d2[i] - f*z2[i];
+    else    d[ind]  = d2[i] - f*z2[i];
+    ind = ind + stride;
+  }
+}
+
+//
+// Precision conversions of the mixed precision solver. Scalars convert implicitly, the SIMD_VEC float lanes of a
+// register become a pair of double registers.
+//
+inline double widen(float x)  { return x; }
+inline float  narrow(double x) { return (float)x; }
+
+#ifdef TRID_SIMD_CONVERT
+struct mixed_vec {
+  simd_traits<double>::vector lo, hi;
+};
+
+inline mixed_vec operator+(const mixed_vec &x, const mixed_vec &y) { mixed_vec r; r.lo = x.lo + y.lo; r.hi = x.hi + y.hi; return r; }
+inline mixed_vec operator-(const mixed_vec &x, const mixed_vec &y) { mixed_vec r; r.lo = x.lo - y.lo; r.hi = x.hi - y.hi; return r; }
+inline mixed_vec operator*(const mixed_vec &x, const mixed_vec &y) { mixed_vec r; r.lo = x.lo * y.lo; r.hi = x.hi * y.hi; return r; }
+
+inline mixed_vec widen(const simd_traits<float>::vector &x) {
+  simd_traits<double>::reg lo, hi;
+  simd_convert::widen(x, lo, hi);
+  mixed_vec r; r.lo = lo; r.hi = hi;
+  return r;
+}
+
+inline simd_traits<float>::vector narrow(const mixed_vec &x) {
+  return simd_convert::narrow(x.lo, x.hi);
+}
+#endif
+
+//
+// Mixed precision solver with iterative refinement. The coefficients a, b and c are stored in single precision, d and
+// the solution in double. The system is factored and solved in single precision, then every refinement step computes
+// the residual d - Ax in double precision and solves for the correction with the single precision factors in the same
+// pass. F is float or a float dvec class, D the matching double type. c2, b2 and d2 are workspaces of N elements of F,
+// x is one of N elements of D.
+//
+template<typename F, typename D, int INC>
+void trid_mixed(const F* __restrict a, const F* __restrict b, const F* __restrict c, D* __restrict d, D* __restrict u, int N, long stride, int nrefine, F* __restrict c2, F* __restrict b2, F* __restrict d2, D* __restrict x) {
+  int  i, k;
+  long ind = 0;
+  F    aa, bb, cc, dd;
+  D    r;
+  F    ones(1.0f);
+  //
+  // single precision factorization and forward pass
+  //
+  bb    = ones / b[0];
+  cc    = bb*c[0];
+  dd    = bb*narrow(d[0]);
+  b2[0] = bb;
+  c2[0] = cc;
+  d2[0] = dd;
+  for(i=1; i<N; i++) {
+    ind   = ind + stride;
+    aa    = a[ind];
+    bb    = ones / (b[ind] - aa*cc);
+    cc    = bb*c[ind];
+    dd    = bb*(narrow(d[ind]) - aa*dd);
+    b2[i] = bb;
+    c2[i] = cc;
+    d2[i] = dd;
+  }
+  //
+  // reverse pass
+  //
+  x[N-1] = widen(dd);
+  for(i=N-2; i>=0; i--) {
+    dd   = d2[i] - c2[i]*dd;
+    x[i] = widen(dd);
+  }
+  //
+  // refinement: double precision residual fused with the forward pass of the correction, then its reverse pass
+  //
+  for(k=0; k<nrefine; k++) {
+    r = d[0] - widen(b[0])*x[0];
+    if(N > 1) r = r - widen(c[0])*x[1];
+    dd    = b2[0]*narrow(r);
+    d2[0] = dd;
+    ind   = 0;
+    for(i=1; i<N-1; i++) {
+      ind   = ind + stride;
+      aa    = a[ind];
+      r     = d[ind] - widen(aa)*x[i-1] - widen(b[ind])*x[i] - widen(c[ind])*x[i+1];
+      dd    = b2[i]*(narrow(r) - aa*dd);
+      d2[i] = dd;
+    }
+    if(N > 1) {
+      ind     = ind + stride;
+      aa      = a[ind];
+      r       = d[ind] - widen(aa)*x[N-2] - widen(b[ind])*x[N-1];
+      dd      = b2[N-1]*(narrow(r) - aa*dd);
+      d2[N-1] = dd;
+    }
+    x[N-1] = x[N-1] + widen(dd);
+    for(i=N-2; i>=0; i--) {
+      dd   = d2[i] - c2[i]*dd;
+      x[i] = x[i] + widen(dd);
+    }
+  }
+  ind = 0;
+  for(i=0; i<N; i++) {
+    if(INC) u[ind] = u[ind] + x[i];
+    else    d[ind] = x[i];
+    ind = ind + stride;
+  }
+}
+
+//
+// Interleave nrows x-rows into dst, element n of row j at dst[n*nrows+j], so that trid_mixed() solves them along the
+// lanes of its vectors, and write them back with trid_x_deinterleave(), which adds them to the rows with INC. nrows is
+// a multiple of SIMD_VEC and the rows are aligned: SIMD_VEC x SIMD_VEC tiles are transposed in registers, the elements
+// past the last whole tile are copied one by one.
+//
+template<typename REAL>
+void trid_x_interleave(const REAL* __restrict src, REAL* __restrict dst, int sys_size, int sys_pad, int nrows) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  const int n_vec    = ROUND_DOWN(sys_size,SIMD_VEC);
+  SIMD_REG  tile[SIMD_VEC];
+  for(int r=0; r<nrows; r+=SIMD_VEC) {
+    for(int n=0; n<n_vec; n+=SIMD_VEC) {
+      LOAD(tile,&src[r*sys_pad],n,sys_pad);
+      store(&dst[n*nrows+r], tile, 0, nrows);
+    }
+    for(int j=r; j<r+SIMD_VEC; j++) {
+      for(int n=n_vec; n<sys_size; n++) dst[n*nrows+j] = src[j*sys_pad+n];
+    }
+  }
+}
+
+template<typename REAL, int INC>
+void trid_x_deinterleave(const REAL* __restrict src, REAL* __restrict dst, int sys_size, int sys_pad, int nrows) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  const int n_vec    = ROUND_DOWN(sys_size,SIMD_VEC);
+  SIMD_REG  tile[SIMD_VEC];
+  for(int r=0; r<nrows; r+=SIMD_VEC) {
+    for(int n=0; n<n_vec; n+=SIMD_VEC) {
+      load(tile, &src[n*nrows+r], 0, nrows);
+      if(INC) {
+        STORE_INC(&dst[r*sys_pad],tile,n,sys_pad);
+      } else {
+        STORE(&dst[r*sys_pad],tile,n,sys_pad);
+      }
+    }
+    for(int j=r; j<r+SIMD_VEC; j++) {
+      for(int n=n_vec; n<sys_size; n++) {
+        if(INC) dst[j*sys_pad+n] += src[n*nrows+j];
+        else    dst[j*sys_pad+n]  = src[n*nrows+j];
+      }
+    }
+  }
+}
+
+//
+// Reduced precision coefficient storage: a, b and c in IEEE half, bfloat16 or float, d and u in float or double. The
+// coefficients are converted to the precision of d when they are loaded.
+//
+struct coef_f16  { typedef unsigned short type; };
+struct coef_bf16 { typedef unsigned short type; };
+struct coef_f32  { typedef float          type; };
+
+inline float half_to_float(unsigned short h) {
+  unsigned int sign = (h & 0x8000u) << 16;
+  unsigned int exp  = (h >> 10) & 0x1f;
+  unsigned int man  = h & 0x3ff;
+  unsigned int bits;
+  if(exp == 0x1f)   bits = sign | 0x7f800000u | (man << 13); // Inf and NaN
+  else if(exp != 0) bits = sign | ((exp + 112) << 23) | (man << 13);
+  else if(man == 0) bits = sign;
+  else { // Subnormal half, normal float
+    exp = 113;
+    while(!(man & 0x400)) { man <<= 1; exp--; }
+    bits = sign | (exp << 23) | ((man & 0x3ff) << 13);
+  }
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+inline float bf16_to_float(unsigned short h) {
+  unsigned int bits = (unsigned int)h << 16;
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+// Load of one coefficient and of SIMD_VEC consecutive ones, the latter may be unaligned
+template<typename FMT, typename REAL> struct coef_load;
+
+template<> struct coef_load<coef_f16,float> {
+  static inline float scalar(const unsigned short *p) { return half_to_float(*p); }
+#ifdef TRID_SIMD_CONVERT
+  static inline simd_traits<float>::vector vector(const unsigned short *p) {
+#ifdef TRID_SIMD_F16
+    return simd_traits<float>::load_f16(p);
+#else
+    float v[simd_traits<float>::vec] __attribute__((aligned(64)));
+    for(int k=0; k<simd_traits<float>::vec; k++) v[k] = half_to_float(p[k]);
+    return *(simd_traits<float>::vector*)v;
+#endif
+  }
+#endif
+};
+
+template<> struct coef_load<coef_bf16,float> {
+  static inline float scalar(const unsigned short *p) { return bf16_to_float(*p); }
+#ifdef TRID_SIMD_CONVERT
+  static inline simd_traits<float>::vector vector(const unsigned short *p) { return simd_traits<float>::load_bf16(p); }
+#endif
+};
+
+template<> struct coef_load<coef_f32,double> {
+  static inline double scalar(const float *p) { return *p; }
+#ifdef TRID_SIMD_CONVERT
+  static inline simd_traits<double>::vector vector(const float *p) { return simd_traits<double>::load_float(p); }
+#endif
+};
+
+// Arithmetic type of trid_scalar_coef(): one system, or SIMD_VEC systems along the lanes
+template<typename FMT, typename REAL> struct coef_scalar {
+  typedef typename FMT::type coef;
+  typedef REAL               type;
+  static inline type load(const coef *p) { return coef_load<FMT,REAL>::scalar(p); }
+};
+
+#ifdef TRID_SIMD_CONVERT
+template<typename FMT, typename REAL> struct coef_vector {
+  typedef typename FMT::type                  coef;
+  typedef typename simd_traits<REAL>::vector type;
+  static inline type load(const coef *p) { return coef_load<FMT,REAL>::vector(p); }
+};
+#endif
+
+//
+// Thomas algorithm on coefficients of reduced precision. L is coef_scalar or coef_vector, strides are in elements.
+// c2 and d2 are workspaces of N elements of L::type.
+//
+template<typename L, typename REAL, int INC>
+void trid_scalar_coef(const typename L::coef* __restrict a, const typename L::coef* __restrict b, const typename L::coef* __restrict c, REAL* __restrict d, REAL* __restrict u, int N, long stride, typename L::type* __restrict c2, typename L::type* __restrict d2) {
+  typedef typename L::type T;
+  int  i;
+  long ind = 0;
+  T    aa, bb, cc, dd;
+  T    ones(1.0f);
+  //
+  // forward pass
+  //
+  bb    = ones / L::load(&b[0]);
+  cc    = bb*L::load(&c[0]);
+  dd    = bb*(*(T*)&d[0]);
+  c2[0] = cc;
+  d2[0] = dd;
+  for(i=1; i<N; i++) {
+    ind   = ind + stride;
+    aa    = L::load(&a[ind]);
+    bb    = ones / (L::load(&b[ind]) - aa*cc);
+    cc    = bb*L::load(&c[ind]);
+    dd    = bb*(*(T*)&d[ind] - aa*dd);
+    c2[i] = cc;
+    d2[i] = dd;
+  }
+  //
+  // reverse pass
+  //
+  if(INC) *(T*)&u[ind] = *(T*)&u[ind] + dd;
+  else    *(T*)&d[ind] = dd;
+  for(i=N-2; i>=0; i--) {
+    ind = ind - stride;
+    dd  = d2[i] - c2[i]*dd;
+    if(INC) *(T*)&u[ind] = *(T*)&u[ind] + dd;
+    else    *(T*)&d[ind] = dd;
+  }
+}
+
+#ifdef TRID_SIMD_CONVERT
+//
+// Convert the coefficients of SIMD_VEC x-rows into dst with the same row padding, so trid_x_transpose() can solve them
+// from cache. Whole vectors are converted: padding to a multiple of SIMD_VEC is required, as for the x-solve of d.
+//
+template<typename FMT, typename REAL>
+void trid_x_coef_rows(const typename FMT::type* __restrict src, REAL* __restrict dst, int sys_size, int sys_pad) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int r=0; r<SIMD_VEC; r++) {
+    for(int n=0; n<sys_size; n+=SIMD_VEC) {
+      *(VECTOR*)&dst[r*sys_pad+n] = coef_load<FMT,REAL>::vector(&src[r*sys_pad+n]);
+    }
+  }
+}
+#endif
+
+//
+// Interleaved batch: element i of system s is at i*stride + s, so SIMD_VEC consecutive systems are one aligned vector
+// and no transpose is needed. G vectors of neighbouring systems are solved together for independent recurrences.
+// c2 and d2 are workspaces of G*N vectors.
+//
+template<typename REAL, int INC, int G>
+void trid_interleaved(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, int N, long stride, typename simd_traits<REAL>::vector* __restrict c2, typename simd_traits<REAL>::vector* __restrict d2) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  int    i, g;
+  long   ind = 0;
+  VECTOR aa, bb, cc[G], dd[G];
+  VECTOR ones(1.0f);
+  //
+  // forward pass
+  //
+  for(g=0; g<G; g++) {
+    bb    = ones / *(VECTOR*)&b[g*SIMD_VEC];
+    cc[g] = bb * *(VECTOR*)&c[g*SIMD_VEC];
+    dd[g] = bb * *(VECTOR*)&d[g*SIMD_VEC];
+    c2[g] = cc[g];
+    d2[g] = dd[g];
+  }
+  for(i=1; i<N; i++) {
+    ind = ind + stride;
+    for(g=0; g<G; g++) {
+      aa    = *(VECTOR*)&a[ind+g*SIMD_VEC];
+      bb    = ones / (*(VECTOR*)&b[ind+g*SIMD_VEC] - aa*cc[g]);
+      cc[g] = bb * *(VECTOR*)&c[ind+g*SIMD_VEC];
+      dd[g] = bb * (*(VECTOR*)&d[ind+g*SIMD_VEC] - aa*dd[g]);
+      c2[i*G+g] = cc[g];
+      d2[i*G+g] = dd[g];
+    }
+  }
+  //
+  // reverse pass
+  //
+  for(i=N-1; i>=0; i--) {
+    for(g=0; g<G; g++) {
+      if(i < N-1) dd[g] = d2[i*G+g] - c2[i*G+g]*dd[g];
+      if(INC) *(VECTOR*)&u[ind+g*SIMD_VEC] = *(VECTOR*)&u[ind+g*SIMD_VEC] + dd[g];
+      else    *(VECTOR*)&d[ind+g*SIMD_VEC] = dd[g];
+    }
+    ind = ind - stride;
+  }
+}
+
+//
+// Transpose a rows x cols matrix, src[r*src_pad+c] to dst[c*dst_pad+r]: SIMD_VEC x SIMD_VEC tiles are transposed in
+// registers if both arrays are aligned, the rest element by element in cache blocks
+//
+template<typename REAL>
+void trid_transpose_block(const REAL* __restrict src, REAL* __restrict dst, long r0, long r1, long c0, long c1, long src_pad, long dst_pad) {
+  const long BLOCK = 32;
+  for(long rb=r0; rb<r1; rb+=BLOCK) {
+    for(long cb=c0; cb<c1; cb+=BLOCK) {
+      for(long r=rb; r<r1 && r<rb+BLOCK; r++) {
+        for(long c=cb; c<c1 && c<cb+BLOCK; c++) dst[c*dst_pad+r] = src[r*src_pad+c];
+      }
+    }
+  }
+}
+
+template<typename REAL>
+void trid_transpose(const REAL* src, REAL* dst, long rows, long cols, long src_pad, long dst_pad) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+  const int aligned    = (long)src % SIMD_WIDTH == 0 && (long)dst % SIMD_WIDTH == 0 && src_pad % SIMD_VEC == 0 && dst_pad % SIMD_VEC == 0;
+  const long rows_vec  = aligned ? ROUND_DOWN(rows,SIMD_VEC) : 0;
+  const long cols_vec  = aligned ? ROUND_DOWN(cols,SIMD_VEC) : 0;
+
+  #pragma omp parallel
+  {
+    #pragma omp for schedule(static) nowait
+    for(long r=0; r<rows_vec; r+=SIMD_VEC) {
+      SIMD_REG tile[SIMD_VEC];
+      for(long c=0; c<cols_vec; c+=SIMD_VEC) {
+        load(tile, &src[r*src_pad], c, src_pad);
+        simd_traits<REAL>::transpose(tile);
+        store(&dst[c*dst_pad], tile, r, dst_pad);
+      }
+      trid_transpose_block(src, dst, r, r+SIMD_VEC, cols_vec, cols, src_pad, dst_pad);
+    }
+    // Rows that don't fill a tile, or every row of unaligned arrays
+    #pragma omp for schedule(static)
+    for(long r=rows_vec; r<rows; r+=32) {
+      trid_transpose_block(src, dst, r, r+32 < rows ? r+32 : rows, 0, cols, src_pad, dst_pad);
+    }
+  }
+}
+
+//
+// Packed {a,b,c,d} quadruples: element e of the batch is p[4*e] to p[4*e+3]. T is REAL for one system, or the dvec
+// class of SIMD_VEC systems along consecutive elements, deinterleaved by simd_packed.
+//
+template<typename REAL>
+inline void packed_load(const REAL* __restrict p, REAL* __restrict r) {
+  r[0] = p[0];
+  r[1] = p[1];
+  r[2] = p[2];
+  r[3] = p[3];
+}
+
+template<typename REAL>
+inline void packed_store_d(REAL* __restrict p, REAL d) {
+  p[3] = d;
+}
+
+#ifdef TRID_SIMD_PACKED
+template<typename REAL>
+inline void packed_load(const REAL* __restrict p, typename simd_traits<REAL>::vector* __restrict r) {
+  simd_packed<REAL>::load(p, (typename simd_traits<REAL>::reg*)r);
+}
+
+template<typename REAL>
+inline void packed_store_d(REAL* __restrict p, typename simd_traits<REAL>::vector d) {
+  simd_packed<REAL>::store_d(p, d);
+}
+#endif
+
+//
+// Thomas algorithm on packed quadruples: p points to the first element, strides are in elements. The solution replaces
+// d in the quadruples, or is added to u in the usual layout if INC is set. c2 and d2 are workspaces of N elements of T.
+//
+template<typename REAL, typename T, int INC>
+void trid_packed(REAL* __restrict p, REAL* __restrict u, int N, long stride, T* __restrict c2, T* __restrict d2) {
+  int  i;
+  long ind = 0;
+  T    r[4], bb, cc, dd;
+  T    ones(1.0f);
+  //
+  // forward pass
+  //
+  packed_load<REAL>(p, r);
+  bb    = ones / r[1];
+  cc    = bb*r[2];
+  dd    = bb*r[3];
+  c2[0] = cc;
+  d2[0] = dd;
+  for(i=1; i<N; i++) {
+    ind   = ind + stride;
+    packed_load<REAL>(&p[4*ind], r);
+    bb    = ones / (r[1] - r[0]*cc);
+    cc    = bb*r[2];
+    dd    = bb*(r[3] - r[0]*dd);
+    c2[i] = cc;
+    d2[i] = dd;
+  }
+  //
+  // reverse pass
+  //
+  for(i=N-1; i>=0; i--) {
+    if(i < N-1) dd = d2[i] - c2[i]*dd;
+    if(INC) *(T*)&u[ind] = *(T*)&u[ind] + dd;
+    else    packed_store_d<REAL>(&p[4*ind], dd);
+    ind = ind - stride;
+  }
+}
+
+#ifdef TRID_SIMD_PACKED
+//
+// Deinterleave the quadruples of SIMD_VEC x-rows into a, b, c and d with the usual row padding, so trid_x_transpose()
+// can solve them from cache, and write the solution back into the quadruples. Rows are padded to whole vectors.
+//
+template<typename REAL>
+void trid_x_packed_rows(const REAL* __restrict p, REAL* __restrict a, REAL* __restrict b, REAL* __restrict c, REAL* __restrict d, int sys_size, int sys_pad) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  SIMD_REG r[4];
+  for(int row=0; row<SIMD_VEC; row++) {
+    for(long n=row*sys_pad; n<row*sys_pad+sys_size; n+=SIMD_VEC) {
+      simd_packed<REAL>::load(&p[4*n], r);
+      *(SIMD_REG*)&a[n] = r[0];
+      *(SIMD_REG*)&b[n] = r[1];
+      *(SIMD_REG*)&c[n] = r[2];
+      *(SIMD_REG*)&d[n] = r[3];
+    }
+  }
+}
+
+template<typename REAL>
+void trid_x_packed_store(REAL* __restrict p, const REAL* __restrict d, int sys_size, int sys_pad) {
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int row=0; row<SIMD_VEC; row++) {
+    for(long n=row*sys_pad; n<row*sys_pad+sys_size; n+=SIMD_VEC) {
+      packed_store_d<REAL>(&p[4*n], *(typename simd_traits<REAL>::vector*)&d[n]);
+    }
+  }
+}
+#endif
+
+//
+// Row i of the systems of trid_ragged() in the lanes of a, b, c and d, consecutive SIMD_VEC values each. Lanes past
+// the end of their system get an identity row.
+//
+template<typename REAL>
+inline void trid_ragged_row(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, const REAL* __restrict d, const long* __restrict off, const int* __restrict len, int i, REAL* __restrict row) {
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  for(int j=0; j<SIMD_VEC; j++) {
+    if(i < len[j]) {
+      long ind = off[j] + i;
+      row[j]            = a[ind];
+      row[SIMD_VEC+j]   = b[ind];
+      row[2*SIMD_VEC+j] = c[ind];
+      row[3*SIMD_VEC+j] = d[ind];
+    } else {
+      row[j]            = 0;
+      row[SIMD_VEC+j]   = 1;
+      row[2*SIMD_VEC+j] = 0;
+      row[3*SIMD_VEC+j] = 0;
+    }
+  }
+}
+
+// Unaligned load and store of a register, which compilers emit for the fixed size copy
+template<typename REAL>
+inline typename simd_traits<REAL>::reg loadu_reg(const REAL* p) {
+  typename simd_traits<REAL>::reg r;
+  memcpy(&r, p, sizeof(r));
+  return r;
+}
+
+template<typename REAL>
+inline void storeu_reg(REAL* p, typename simd_traits<REAL>::reg r) {
+  memcpy(p, &r, sizeof(r));
+}
+
+//
+// Ragged batch: SIMD_VEC contiguous systems of different lengths, system j with len[j] rows starting at off[j], solved
+// in one vector for the N rows of the longest one. Rows every system has are loaded SIMD_VEC at a time from each system
+// and transposed in registers, as in trid_x_transpose(). The identity rows (a = c = d = 0, b = 1) past the end of a
+// system have zero solution and don't couple back to its last row, so every lane gets the solution of its own system.
+// Unused lanes have length 0. c2 and d2 are workspaces of N vectors.
+//
+template<typename REAL, int INC>
+void trid_ragged(const REAL* __restrict a, const REAL* __restrict b, const REAL* __restrict c, REAL* __restrict d, REAL* __restrict u, const long* __restrict off, const int* __restrict len, int N, typename simd_traits<REAL>::vector* __restrict c2, typename simd_traits<REAL>::vector* __restrict d2) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  typedef typename simd_traits<REAL>::reg    SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  int    i, n;
+  VECTOR aa, bb, cc, dd;
+  VECTOR ones(1.0f);
+  VECTOR row[4]; // a, b, c and d of a row past the end of some system
+  SIMD_REG a_reg[SIMD_VEC];
+  SIMD_REG b_reg[SIMD_VEC];
+  SIMD_REG c_reg[SIMD_VEC];
+  SIMD_REG d_reg[SIMD_VEC];
+
+  int full = N; // Rows of the shortest system, in whole blocks of SIMD_VEC
+  for(int j=0; j<SIMD_VEC; j++) full = len[j] < full ? len[j] : full;
+  full = ROUND_DOWN(full,SIMD_VEC);
+  //
+  // forward pass, a of the first row is ignored
+  //
+  cc = VECTOR(0.0f);
+  dd = VECTOR(0.0f);
+  for(n=0; n<full; n+=SIMD_VEC) {
+    for(int j=0; j<SIMD_VEC; j++) {
+      a_reg[j] = loadu_reg<REAL>(&a[off[j]+n]);
+      b_reg[j] = loadu_reg<REAL>(&b[off[j]+n]);
+      c_reg[j] = loadu_reg<REAL>(&c[off[j]+n]);
+      d_reg[j] = loadu_reg<REAL>(&d[off[j]+n]);
+    }
+    simd_traits<REAL>::transpose(a_reg);
+    simd_traits<REAL>::transpose(b_reg);
+    simd_traits<REAL>::transpose(c_reg);
+    simd_traits<REAL>::transpose(d_reg);
+    for(i=0; i<SIMD_VEC; i++) {
+      aa = (n+i == 0) ? VECTOR(0.0f) : VECTOR(a_reg[i]);
+      bb = ones / (VECTOR(b_reg[i]) - aa*cc);
+      cc = bb * VECTOR(c_reg[i]);
+      dd = bb * (VECTOR(d_reg[i]) - aa*dd);
+      c2[n+i] = cc;
+      d2[n+i] = dd;
+    }
+  }
+  for(i=full; i<N; i++) {
+    trid_ragged_row<REAL>(a, b, c, d, off, len, i, (REAL*)row);
+    aa    = (i == 0) ? VECTOR(0.0f) : row[0];
+    bb    = ones / (row[1] - aa*cc);
+    cc    = bb * row[2];
+    dd    = bb * (row[3] - aa*dd);
+    c2[i] = cc;
+    d2[i] = dd;
+  }
+  //
+  // reverse pass
+  //
+  for(i=N-1; i>=full; i--) {
+    if(i < N-1) dd = d2[i] - c2[i]*dd;
+    row[3] = dd;
+    for(int j=0; j<SIMD_VEC; j++) {
+      if(i < len[j]) {
+        if(INC) u[off[j]+i] += ((REAL*)&row[3])[j];
+        else    d[off[j]+i]  = ((REAL*)&row[3])[j];
+      }
+    }
+  }
+  for(n=full-SIMD_VEC; n>=0; n-=SIMD_VEC) {
+    for(i=SIMD_VEC-1; i>=0; i--) {
+      if(n+i < N-1) dd = d2[n+i] - c2[n+i]*dd;
+      d_reg[i] = dd;
+    }
+    simd_traits<REAL>::transpose(d_reg);
+    for(int j=0; j<SIMD_VEC; j++) {
+      if(INC) storeu_reg<REAL>(&u[off[j]+n], simd_traits<REAL>::add(loadu_reg<REAL>(&u[off[j]+n]), d_reg[j]));
+      else    storeu_reg<REAL>(&d[off[j]+n], d_reg[j]);
+    }
+  }
+}
+
+//
+// Hybrid Thomas-PCR solver for a few long systems. Every system is split into chunks, which are reduced independently
+// with a modified Thomas algorithm to two boundary equations. The reduced system of the boundary unknowns of every
+// chunk is solved with PCR, then the inner unknowns of the chunks are substituted. T is either REAL or a dvec class
+// for SIMD_VEC systems.
+//
+// Reduce a chunk of M >= 3 rows: row i becomes aa[i]*x[0] + x[i] + cc[i]*x[M-1] = dd[i] for 0 < i < M-1, the first and
+// last rows couple the chunk to its neighbours and are copied to rows 2p and 2p+1 of the reduced system ra, rc, rd
+//
+template<typename T>
+void trid_hybrid_reduce(const T* __restrict a, const T* __restrict b, const T* __restrict c, const T* __restrict d, long stride, int M, int first, int last, T* __restrict aa, T* __restrict cc, T* __restrict dd, T* __restrict ra, T* __restrict rc, T* __restrict rd, int p) {
+  int  i;
+  long ind;
+  T    bbi;
+  T    ones(1.0f);
+  T    zero(0.0f);
+
+  for(i=0; i<2; i++) {
+    ind   = i*stride;
+    bbi   = ones / b[ind];
+    dd[i] = bbi*d[ind];
+    aa[i] = bbi*a[ind];
+    cc[i] = bbi*c[ind];
+  }
+  if(first) aa[0] = zero; // a of the first row is not part of the system
+  for(i=2; i<M; i++) {
+    ind   = i*stride;
+    bbi   = ones / (b[ind] - a[ind]*cc[i-1]);
+    dd[i] = bbi*(d[ind] - a[ind]*dd[i-1]);
+    aa[i] = bbi*(zero - a[ind]*aa[i-1]);
+    cc[i] = bbi*c[ind];
+  }
+  if(last) cc[M-1] = zero; // c of the last row is not part of the system
+  for(i=M-3; i>0; i--) {
+    dd[i] = dd[i] - cc[i]*dd[i+1];
+    aa[i] = aa[i] - cc[i]*aa[i+1];
+    cc[i] = zero - cc[i]*cc[i+1];
+  }
+  bbi   = ones / (ones - cc[0]*aa[1]);
+  dd[0] = bbi*(dd[0] - cc[0]*dd[1]);
+  aa[0] = bbi*aa[0];
+  cc[0] = bbi*(zero - cc[0]*cc[1]);
+
+  ra[2*p]   = aa[0];
+  rc[2*p]   = cc[0];
+  rd[2*p]   = dd[0];
+  ra[2*p+1] = aa[M-1];
+  rc[2*p+1] = cc[M-1];
+  rd[2*p+1] = dd[M-1];
+}
+
+//
+// PCR solve of the reduced system of n rows with unit diagonal. a2, c2 and d2 are workspaces of n elements, the
+// solution is returned in d.
+//
+template<typename T>
+void trid_hybrid_pcr(T* __restrict a, T* __restrict c, T* __restrict d, T* __restrict a2, T* __restrict c2, T* __restrict d2, int n) {
+  int i, s;
+  T   r;
+  T   ones(1.0f);
+  T   zero(0.0f);
+  T  *sa = a, *sc = c, *sd = d, *t;
+
+  for(s=1; s<n; s*=2) {
+    for(i=0; i<n; i++) {
+      T am = (i-s >= 0) ? sa[i-s] : zero, cm = (i-s >= 0) ? sc[i-s] : zero, dm = (i-s >= 0) ? sd[i-s] : zero;
+      T ap = (i+s <  n) ? sa[i+s] : zero, cp = (i+s <  n) ? sc[i+s] : zero, dp = (i+s <  n) ? sd[i+s] : zero;
+      r     = ones / (ones - sa[i]*cm - sc[i]*ap);
+      a2[i] = r*(zero - sa[i]*am);
+      c2[i] = r*(zero - sc[i]*cp);
+      d2[i] = r*(sd[i] - sa[i]*dm - sc[i]*dp);
+    }
+    t = sa; sa = a2; a2 = t;
+    t = sc; sc = c2; c2 = t;
+    t = sd; sd = d2; d2 = t;
+  }
+  if(sd != d) for(i=0; i<n; i++) d[i] = sd[i];
+}
+
+//
+// Substitute the boundary unknowns x0 and x1 of a chunk into its inner rows
+//
+template<typename T, int INC>
+void trid_hybrid_substitute(T* __restrict d, T* __restrict u, long stride, int M, const T* __restrict aa, const T* __restrict cc, const T* __restrict dd, T x0, T x1) {
+  T    xx;
+  long ind;
+  for(int i=0; i<M; i++) {
+    ind = i*stride;
+    if(i == 0)        xx = x0;
+    else if(i == M-1) xx = x1;
+    else              xx = dd[i] - aa[i]*x0 - cc[i]*x1;
+    if(INC) u[ind] += xx;
+    else    d[ind]  = xx;
+  }
+}
+
+//
+// Set up the geometry of a batch solve in a specific dimension. Workspace and offset table are not allocated.
+//
+template<typename REAL>
+tridStatus_t trid_plan_init(tridPlan_st *plan, int ndim, int solvedim, const int *dims, const int *pads) {
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  plan->outer   = NULL; // Allocations are released by trid_plan_free() even if the set up fails
+  plan->ws      = NULL;
+  plan->hws     = NULL;
+  plan->factors = NULL;
+  if(ndim < 1 || ndim > MAXDIM || solvedim < 0 || solvedim >= ndim) return TRID_STATUS_INVALID_VALUE;
+
+  long cumdims[MAXDIM+1]; // Cummulative-multiplication of dimensions
+  cumdims[0]       = 1;
+  plan->cumpads[0] = 1;
+  for(int i=0; i<ndim; i++) {
+    if(dims[i] < 1 || pads[i] < dims[i]) return TRID_STATUS_INVALID_VALUE;
+    plan->dims[i]      = dims[i];
+    plan->pads[i]      = pads[i];
+    cumdims[i+1]       = cumdims[i]*dims[i];
+    plan->cumpads[i+1] = plan->cumpads[i]*pads[i];
+  }
+  plan->kernels    = NULL;
+  plan->real_size  = sizeof(REAL);
+  plan->ndim       = ndim;
+  plan->solvedim   = solvedim;
+  plan->sys_size   = dims[solvedim];
+  plan->sys_stride = plan->cumpads[solvedim];
+
+  // The fastest non-solved dimension is mapped onto the SIMD lanes: rows of the x dimension are transposed in registers
+  // for the x-solve, while consecutive x elements are loaded as vectors for every other solve
+  plan->lanedim = (solvedim == 0) ? 1 : 0;
+  if(plan->lanedim >= ndim) { // 1D problem: single system
+    plan->lanedim     = -1;
+    plan->lane_n      = 1;
+    plan->lane_stride = 0;
+    plan->lane_vec    = 0;
+  } else {
+    plan->lane_n      = dims[plan->lanedim];
+    plan->lane_stride = plan->cumpads[plan->lanedim];
+    plan->lane_vec    = (solvedim != 0 || plan->sys_size >= SIMD_VEC) ? ROUND_DOWN(plan->lane_n,SIMD_VEC) : 0;
+  }
+  plan->out_n    = cumdims[ndim] / ((long)plan->sys_size * plan->lane_n);
+  plan->nthreads = omp_get_max_threads();
+  plan->ws_len   = 0;
+  plan->hws_len  = 0;
+  plan->fact_len      = 0;
+  plan->fact_vec      = 0;
+  plan->fact_toeplitz = 0;
+
+  // TRID_CPU_X_COMPACT=1 solves the x-systems with trid_x_transpose_compact() instead of trid_x_transpose(). It
+  // hasn't been measured to be faster on any ISA, so it is off by default; apps/adi/tools/sweep_x.sh compares the two.
+  plan->x_compact = 0;
+  const char *env = getenv("TRID_CPU_X_COMPACT");
+  if(env != NULL && atoi(env) == 1) plan->x_compact = 1;
+  if(solvedim != 0) plan->x_compact = 0;
+
+  // Rows that can't be transposed, because they are unaligned, unpadded or shorter than SIMD_VEC, are gathered by
+  // trid_x_gather() where the ISA has gathers. TRID_CPU_X_GATHER=<0|1|2> selects never, these rows only, or always.
+#ifdef TRID_SIMD_GATHER
+  plan->x_gather = 1;
+#else
+  plan->x_gather = 0;
+#endif
+  env = getenv("TRID_CPU_X_GATHER");
+  if(env != NULL && plan->x_gather) plan->x_gather = atoi(env);
+  if(plan->x_gather < 0) plan->x_gather = 0;
+  if(plan->x_gather > 2) plan->x_gather = 2;
+  if(solvedim != 0 || plan->lanedim < 0 || (SIMD_VEC-1)*plan->lane_stride > INT_MAX) plan->x_gather = 0; // 32 bit offsets
+
+  // Systems along the lanes of the y- and z-solves that don't fill a vector, and all of them if the arrays aren't
+  // aligned, are solved by trid_scalar_vec_masked() where the ISA has masked loads and stores. TRID_CPU_MASK=0 solves
+  // them one by one with trid_scalar() instead.
+#ifdef TRID_SIMD_MASK
+  plan->lane_mask = 1;
+#else
+  plan->lane_mask = 0;
+#endif
+  env = getenv("TRID_CPU_MASK");
+  if(env != NULL && atoi(env) == 0) plan->lane_mask = 0;
+  if(solvedim == 0 || plan->lanedim < 0) plan->lane_mask = 0;
+
+  // When there are too few systems to keep every thread busy, the systems are split into chunks for the hybrid
+  // Thomas-PCR solver. Systems along the SIMD lanes are still solved together in vectors, except in the x-solve.
+  // TRID_CPU_HYBRID=0 disables the hybrid solver.
+  long groups = (solvedim == 0) ? plan->out_n*plan->lane_n : plan->out_n*(plan->lane_vec/SIMD_VEC + plan->lane_n - plan->lane_vec);
+  plan->hybrid_chunks = 0;
+  env = getenv("TRID_CPU_HYBRID");
+  if((env == NULL || atoi(env) != 0) && plan->nthreads > 1 && groups < plan->nthreads) {
+    long chunks = (HYBRID_CHUNKS_PER_THREAD*plan->nthreads + groups-1) / groups;
+    if(chunks > plan->sys_size/HYBRID_MIN_CHUNK) chunks = plan->sys_size/HYBRID_MIN_CHUNK;
+    if(chunks > 1) plan->hybrid_chunks = chunks;
+  }
+
+  // The SIMD kernels can write the solution with non-temporal stores. d is read by the forward pass, so this saves the
+  // read for ownership only if its lines are evicted before the reverse pass, see trid_plan_stream(). TRID_CPU_STREAM=
+  // <0|1|2> selects never, long systems only or always. tridPlanSetStream() changes it for a plan.
+  plan->stream = 1;
+  env = getenv("TRID_CPU_STREAM");
+  if(env != NULL) plan->stream = atoi(env);
+  if(plan->stream < 0) plan->stream = 0;
+  if(plan->stream > 2) plan->stream = 2;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  plan->cache_bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#else
+  plan->cache_bytes = 0;
+#endif
+  if(plan->cache_bytes <= 0) plan->cache_bytes = STREAM_CACHE_BYTES;
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// Allocate the per-thread workspace for the modified c and the nrhs modified d coefficients of the forward pass of
+// SIMD_VEC systems, and optionally the table of the system row offsets. Every part of the workspace is a multiple of
+// SIMD_WIDTH, so they all stay aligned.
+//
+template<typename REAL>
+tridStatus_t trid_plan_alloc(tridPlan_st *plan, int outer_table, int nrhs) {
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+
+  int parts = (1+nrhs < 2 && plan->x_compact) ? 2 : 1+nrhs; // trid_x_transpose_compact() needs 2
+  int vec      = plan->lane_vec > 0 || plan->x_gather || plan->lane_mask || (plan->solvedim == 0 && plan->lanedim >= 0 && plan->sys_size >= SIMD_VEC); // Last x-item
+  plan->ws_len = (long)(vec ? SIMD_VEC : 1) * plan->sys_size;
+  plan->ws_len = ROUND_DOWN(plan->ws_len + SIMD_VEC-1, SIMD_VEC) * parts;
+  plan->ws     = _mm_malloc(sizeof(REAL)*plan->ws_len*plan->nthreads, SIMD_WIDTH);
+  if(plan->ws == NULL) return TRID_STATUS_ALLOC_FAILED;
+
+  // Every system of the hybrid solver keeps the coefficients of its chunks and its reduced system with a second buffer
+  if(plan->hybrid_chunks > 0) {
+    plan->hws_len = ROUND_DOWN(3L*plan->sys_size + 12*plan->hybrid_chunks + SIMD_VEC-1, SIMD_VEC);
+    plan->hws     = _mm_malloc(sizeof(REAL)*plan->hws_len*plan->out_n*plan->lane_n, SIMD_WIDTH);
+    if(plan->hws == NULL) return TRID_STATUS_ALLOC_FAILED;
+  }
+
+  if(outer_table) {
+    plan->outer = (long*) malloc(sizeof(long)*plan->out_n);
+    if(plan->outer == NULL) return TRID_STATUS_ALLOC_FAILED;
+    for(long k=0; k<plan->out_n; k++)
+      plan->outer[k] = outer_offset(k, plan->ndim, plan->solvedim, plan->lanedim, plan->dims, plan->cumpads);
+  }
+  return TRID_STATUS_SUCCESS;
+}
+
+inline void trid_plan_free(tridPlan_st *plan) {
+  if(plan->ws      != NULL) _mm_free(plan->ws);
+  if(plan->hws     != NULL) _mm_free(plan->hws);
+  if(plan->outer   != NULL) free(plan->outer);
+  if(plan->factors != NULL) _mm_free(plan->factors);
+  plan->ws      = NULL;
+  plan->hws     = NULL;
+  plan->outer   = NULL;
+  plan->factors = NULL;
+}
+
+//
+// Solve a batch set up by trid_plan_init() and trid_plan_alloc() with the hybrid Thomas-PCR solver. A line group is
+// SIMD_VEC systems solved in vectors or a single system, whose workspace starts at the workspace of its first system.
+//
+template<typename REAL, int INC>
+void trid_plan_solve_hybrid(const tridPlan_st *plan, const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   N           = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long *outer       = plan->outer;
+  const int   P           = plan->hybrid_chunks;
+  const int   lane_vec    = (solvedim != 0 && is_simd_aligned(a, b, c, d, INC ? u : NULL, plan->pads[0])) ? plan->lane_vec : 0;
+  const int   nv          = lane_vec/SIMD_VEC;        // Vector line groups along the lanes
+  const int   nl          = nv + lane_n - lane_vec;   // All line groups along the lanes
+  const long  ng          = plan->out_n * nl;
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    #pragma omp for collapse(2) schedule(static)
+    for(long g=0; g<ng; g++) {
+      for(int p=0; p<P; p++) {
+        long k    = g / nl;
+        int  r    = g % nl;
+        int  l    = (r < nv) ? r*SIMD_VEC : lane_vec + (r-nv);
+        long beg  = (long)p*N/P;
+        int  M    = (int)((long)(p+1)*N/P - beg);
+        long ind  = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride + beg*sys_stride;
+        REAL *w   = &((REAL*)plan->hws)[(k*lane_n + l)*plan->hws_len];
+        if(r < nv) {
+          VECTOR *wv = (VECTOR*)w;
+          trid_hybrid_reduce<VECTOR>((const VECTOR*)&a[ind], (const VECTOR*)&b[ind], (const VECTOR*)&c[ind], (const VECTOR*)&d[ind], sys_stride/SIMD_VEC, M, p == 0, p == P-1,
+                                     &wv[beg], &wv[N+beg], &wv[2*N+beg], &wv[3*N], &wv[3*N+2*P], &wv[3*N+4*P], p);
+        } else {
+          trid_hybrid_reduce<REAL>(&a[ind], &b[ind], &c[ind], &d[ind], sys_stride, M, p == 0, p == P-1,
+                                   &w[beg], &w[N+beg], &w[2*N+beg], &w[3*N], &w[3*N+2*P], &w[3*N+4*P], p);
+        }
+      }
+    }
+    #pragma omp for schedule(static)
+    for(long g=0; g<ng; g++) {
+      long k = g / nl;
+      int  r = g % nl;
+      int  l = (r < nv) ? r*SIMD_VEC : lane_vec + (r-nv);
+      REAL *w = &((REAL*)plan->hws)[(k*lane_n + l)*plan->hws_len];
+      if(r < nv) {
+        VECTOR *rv = &((VECTOR*)w)[3*N];
+        trid_hybrid_pcr<VECTOR>(rv, &rv[2*P], &rv[4*P], &rv[6*P], &rv[8*P], &rv[10*P], 2*P);
+      } else {
+        REAL *rs = &w[3*N];
+        trid_hybrid_pcr<REAL>(rs, &rs[2*P], &rs[4*P], &rs[6*P], &rs[8*P], &rs[10*P], 2*P);
+      }
+    }
+    #pragma omp for collapse(2) schedule(static)
+    for(long g=0; g<ng; g++) {
+      for(int p=0; p<P; p++) {
+        long k    = g / nl;
+        int  r    = g % nl;
+        int  l    = (r < nv) ? r*SIMD_VEC : lane_vec + (r-nv);
+        long beg  = (long)p*N/P;
+        int  M    = (int)((long)(p+1)*N/P - beg);
+        long ind  = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride + beg*sys_stride;
+        REAL *w   = &((REAL*)plan->hws)[(k*lane_n + l)*plan->hws_len];
+        if(r < nv) {
+          VECTOR *wv = (VECTOR*)w;
+          trid_hybrid_substitute<VECTOR,INC>((VECTOR*)&d[ind], (VECTOR*)&u[ind], sys_stride/SIMD_VEC, M, &wv[beg], &wv[N+beg], &wv[2*N+beg], wv[3*N+4*P+2*p], wv[3*N+4*P+2*p+1]);
+        } else {
+          trid_hybrid_substitute<REAL,INC>(&d[ind], &u[ind], sys_stride, M, &w[beg], &w[N+beg], &w[2*N+beg], w[3*N+4*P+2*p], w[3*N+4*P+2*p+1]);
+        }
+      }
+    }
+  }
+}
+
+//
+// Whether the solution of a plan is written with non-temporal stores, see trid_plan_init(). A vector of systems reads
+// sys_size registers of a, b, c and d before its reverse pass, and streaming pays off when they overflow the L2 cache.
+// Narrower registers than a cache line write partial lines, which is slower than the read for ownership.
+//
+template<typename REAL>
+inline int trid_plan_stream(const tridPlan_st *plan) {
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  return plan->stream == 2 || (plan->stream == 1 && SIMD_WIDTH >= 64 && 4L*plan->sys_size*SIMD_WIDTH > plan->cache_bytes);
+}
+
+//
+// Block of the n work items of a plan solve that a thread takes: contiguous, with one item more for the first
+// n % nthreads threads. Neighbouring items share pages, so with round robin scheduling every thread would touch
+// every page of the y- and z-solves, and of any solve with 2 MB pages. Blocks of whole system rows don't.
+//
+inline void trid_static_block(long n, int thread, int nthreads, long *beg, long *end) {
+  const long q = n / nthreads;
+  const long r = n % nthreads;
+  *beg = thread*q + (thread < r ? thread : r);
+  *end = *beg + q + (thread < r ? 1 : 0);
+}
+
+//
+// Systems along the lanes solved in the SIMD work items of trid_plan_solve(). With masked lanes these are all of them,
+// and so they are in the x-solve if the rows are gathered, or aligned and at least SIMD_VEC long: the last work item
+// then holds the lane_n % SIMD_VEC rows left over. Otherwise the systems past the aligned ones are solved one by one.
+//
+template<typename REAL>
+inline int trid_plan_lane_simd(const tridPlan_st *plan, int aligned, int x_gather) {
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  if(plan->lane_mask || x_gather) return plan->lane_n;
+  if(!aligned) return 0;
+  if(plan->solvedim == 0 && plan->lanedim >= 0 && plan->sys_size >= SIMD_VEC) return plan->lane_n;
+  return plan->lane_vec;
+}
+
+//
+// Solve the SIMD work item of trid_plan_solve() that starts at system l of the system row at offset ind: SIMD_VEC
+// systems, the rows left over in the last x-item, or with masked lanes the systems past the aligned ones
+//
+template<typename REAL, int INC>
+inline void trid_plan_solve_vec(const tridPlan_st *plan, const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u, long ind, int l, int lane_vec, int x_gather, int stream, REAL* c2, REAL* d2) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  typedef typename simd_traits<REAL>::reg    SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+  const int sys_size = plan->sys_size;
+
+  const int rows     = plan->lane_n-l; // Systems left in the last x-item
+
+  ind += l*plan->lane_stride;
+#ifdef TRID_SIMD_GATHER
+  if(x_gather) {
+    if(rows < SIMD_VEC) trid_x_gather<REAL,INC,1>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, simd_traits<REAL>::lanes(plan->lane_stride), rows, (SIMD_REG*)c2, (SIMD_REG*)d2);
+    else                trid_x_gather<REAL,INC,0>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, simd_traits<REAL>::lanes(plan->lane_stride), SIMD_VEC, (SIMD_REG*)c2, (SIMD_REG*)d2);
+    return;
+  }
+#else
+  (void)x_gather; // Always 0 without gathers
+#endif
+#ifndef TRID_SIMD_MASK
+  (void)lane_vec; // Only masked lanes lie past lane_vec
+#endif
+  if(plan->solvedim == 0 && rows < SIMD_VEC) {
+    if(stream) trid_x_transpose<REAL,INC,1,1>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->pads[0], 1, rows, (SIMD_REG*)c2, (SIMD_REG*)d2);
+    else       trid_x_transpose<REAL,INC,0,1>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->pads[0], 1, rows, (SIMD_REG*)c2, (SIMD_REG*)d2);
+  } else if(plan->solvedim == 0 && plan->x_compact) {
+    if(stream) trid_x_transpose_compact<REAL,INC,1>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->pads[0], (SIMD_REG*)c2);
+    else       trid_x_transpose_compact<REAL,INC,0>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->pads[0], (SIMD_REG*)c2);
+  } else if(plan->solvedim == 0) {
+    if(stream) trid_x_transpose<REAL,INC,1,0>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->pads[0], 1, SIMD_VEC, (SIMD_REG*)c2, (SIMD_REG*)d2);
+    else       trid_x_transpose<REAL,INC,0,0>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->pads[0], 1, SIMD_VEC, (SIMD_REG*)c2, (SIMD_REG*)d2);
+#ifdef TRID_SIMD_MASK
+  } else if(l+SIMD_VEC > lane_vec) {
+    int n = plan->lane_n-l < SIMD_VEC ? plan->lane_n-l : SIMD_VEC;
+    trid_scalar_vec_masked<REAL,INC>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->sys_stride, n, (VECTOR*)c2, (VECTOR*)d2);
+#endif
+  } else {
+    if(stream) trid_scalar_vec<REAL,VECTOR,INC,1>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->sys_stride/SIMD_VEC, (VECTOR*)c2, (VECTOR*)d2);
+    else       trid_scalar_vec<REAL,VECTOR,INC,0>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, plan->sys_stride/SIMD_VEC, (VECTOR*)c2, (VECTOR*)d2);
+  }
+}
+
+//
+// Solve a batch set up by trid_plan_init() and trid_plan_alloc()
+//
+template<typename REAL, int INC>
+void trid_plan_solve(const tridPlan_st *plan, const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u) {
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  if(plan->hybrid_chunks > 0) {
+    trid_plan_solve_hybrid<REAL,INC>(plan, a, b, c, d, u);
+    return;
+  }
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  const int   aligned     = is_simd_aligned(a, b, c, d, INC ? u : NULL, plan->pads[0]);
+  const int   lane_vec    = aligned ? plan->lane_vec : 0;
+  const int   x_gather    = plan->x_gather == 2 || (plan->x_gather == 1 && lane_vec == 0);
+  const int   lane_simd   = trid_plan_lane_simd<REAL>(plan, aligned, x_gather); // Systems solved in SIMD vectors
+  const int   nvec        = (lane_simd + SIMD_VEC-1) / SIMD_VEC;                   // SIMD work items per system row
+  const int   nitems      = nvec + lane_n - lane_simd;                             // and the leftover systems after them
+  const int   stream      = !INC && trid_plan_stream<REAL>(plan);
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    REAL *c2 = &((REAL*)plan->ws)[omp_get_thread_num()*plan->ws_len];
+    REAL *d2 = &c2[plan->ws_len/2];
+
+    // Contiguous blocks of system rows, so the pages of a thread's systems are its own, see trid_static_block()
+    long beg, end;
+    trid_static_block(out_n*nitems, omp_get_thread_num(), omp_get_num_threads(), &beg, &end);
+    for(long it=beg; it<end; it++) {
+      long k   = it / nitems;
+      int  j   = it % nitems;
+      long ind = outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads);
+      if(j < nvec) {
+        trid_plan_solve_vec<REAL,INC>(plan, a, b, c, d, u, ind, j*SIMD_VEC, lane_vec, x_gather, stream, c2, d2);
+      } else { // Leftover systems that can't be solved in a SIMD vector, see trid_plan_lane_simd()
+        ind += (lane_simd + j-nvec)*lane_stride;
+        trid_scalar<REAL,INC>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_stride, c2, d2);
+      }
+    }
+#ifndef __MIC__
+    if(stream) _mm_sfence(); // Non-temporal stores are weakly ordered
+#endif
+  }
+}
+
+//
+// Allocate the factors of a plan and compute them with trid_factor(). Factors are stored with the offsets of the
+// coefficients, except for the x-systems solved SIMD_VEC at a time: the factors of such a group of rows are
+// interleaved in the place of the rows.
+//
+template<typename REAL>
+tridStatus_t trid_plan_factor(tridPlan_st *plan, const REAL* a, const REAL* b, const REAL* c) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+
+  if(plan->factors != NULL && plan->fact_toeplitz) {
+    _mm_free(plan->factors);
+    plan->factors = NULL;
+  }
+  if(plan->factors == NULL) {
+    plan->fact_toeplitz = 0;
+    plan->fact_len      = ROUND_DOWN(plan->cumpads[plan->ndim] + SIMD_VEC-1, SIMD_VEC);
+    plan->factors       = _mm_malloc(3*sizeof(REAL)*plan->fact_len, SIMD_WIDTH);
+    if(plan->factors == NULL) return TRID_STATUS_ALLOC_FAILED;
+  }
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  REAL       *rb          = (REAL*)plan->factors;
+  REAL       *ra          = &rb[plan->fact_len];
+  REAL       *rc          = &ra[plan->fact_len];
+  int         lane_vec;
+
+  if(solvedim == 0) {
+    lane_vec       = (plan->pads[0] % SIMD_VEC == 0) ? plan->lane_vec : 0;
+    plan->fact_vec = lane_vec;
+  } else {
+    lane_vec       = is_simd_aligned(a, b, c, a, (REAL*)NULL, plan->pads[0]) ? plan->lane_vec : 0;
+    plan->fact_vec = 0;
+  }
+
+  const int   nvec        = lane_vec / SIMD_VEC;
+  const int   nitems      = nvec + lane_n - lane_vec;
+
+  // Blocks of system rows as in trid_plan_solve(), so the factors are first touched by the threads that read them
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    long beg, end;
+    trid_static_block(out_n*nitems, omp_get_thread_num(), omp_get_num_threads(), &beg, &end);
+    for(long it=beg; it<end; it++) {
+      long k   = it / nitems;
+      int  j   = it % nitems;
+      long ind = outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads);
+      if(j >= nvec) {
+        ind += (lane_vec + j-nvec)*lane_stride;
+        trid_factor<REAL>(&a[ind], &b[ind], &c[ind], sys_stride, &rb[ind], &ra[ind], &rc[ind], sys_stride, sys_size);
+      } else if(solvedim == 0) {
+        ind += j*SIMD_VEC*lane_stride;
+        for(int i=0; i<SIMD_VEC; i++)
+          trid_factor<REAL>(&a[ind+i*lane_stride], &b[ind+i*lane_stride], &c[ind+i*lane_stride], 1, &rb[ind+i], &ra[ind+i], &rc[ind+i], SIMD_VEC, sys_size);
+      } else {
+        ind += j*SIMD_VEC*lane_stride;
+        trid_factor<VECTOR>((VECTOR*)&a[ind], (VECTOR*)&b[ind], (VECTOR*)&c[ind], sys_stride/SIMD_VEC, (VECTOR*)&rb[ind], (VECTOR*)&ra[ind], (VECTOR*)&rc[ind], sys_stride/SIMD_VEC, sys_size);
+      }
+    }
+  }
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// Replace the factors of a plan with the single sequence of Toeplitz factors of trid_factor_toeplitz()
+//
+template<typename REAL>
+tridStatus_t trid_plan_factor_toeplitz(tridPlan_st *plan, REAL a, REAL b, REAL c, REAL b0, REAL c0, REAL an, REAL bn) {
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+
+  if(plan->factors != NULL && !plan->fact_toeplitz) {
+    _mm_free(plan->factors);
+    plan->factors = NULL;
+  }
+  if(plan->factors == NULL) {
+    plan->fact_toeplitz = 1;
+    plan->fact_vec      = 0;
+    plan->fact_len      = ROUND_DOWN(plan->sys_size + SIMD_VEC-1, SIMD_VEC);
+    plan->factors       = _mm_malloc(3*sizeof(REAL)*plan->fact_len, SIMD_WIDTH);
+    if(plan->factors == NULL) return TRID_STATUS_ALLOC_FAILED;
+  }
+  REAL *rb = (REAL*)plan->factors;
+  trid_factor_toeplitz<REAL>(a, b, c, b0, c0, an, bn, rb, &rb[plan->fact_len], &rb[2*plan->fact_len], plan->sys_size);
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// Solve a batch with the factors computed by trid_plan_factor() or trid_plan_factor_toeplitz()
+//
+template<typename REAL, int INC>
+void trid_plan_solve_factored(const tridPlan_st *plan, REAL* d, REAL* u) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  typedef typename simd_traits<REAL>::reg    SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  const int   fact_vec    = plan->fact_vec;
+  const int   toeplitz    = plan->fact_toeplitz;
+  // The factors are allocated aligned, with the same offsets as d
+  const int   lane_vec    = is_simd_aligned(d, d, d, d, INC ? u : NULL, plan->pads[0]) ? plan->lane_vec : 0;
+  const REAL *rb          = (const REAL*)plan->factors;
+  const REAL *ra          = &rb[plan->fact_len];
+  const REAL *rc          = &ra[plan->fact_len];
+  const int   nvec        = lane_vec / SIMD_VEC;
+  const int   nitems      = nvec + lane_n - lane_vec;
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    REAL *d2 = &((REAL*)plan->ws)[omp_get_thread_num()*plan->ws_len];
+
+    // Blocks of system rows as in trid_plan_solve()
+    long beg, end;
+    trid_static_block(out_n*nitems, omp_get_thread_num(), omp_get_num_threads(), &beg, &end);
+    for(long it=beg; it<end; it++) {
+      long k   = it / nitems;
+      int  j   = it % nitems;
+      long ind = outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads);
+      if(j < nvec) {
+        ind += j*SIMD_VEC*lane_stride;
+        if(toeplitz) {
+          if(solvedim == 0) trid_x_transpose_factored<REAL,1,INC>(rb, ra, rc, &d[ind], &u[ind], sys_size, plan->pads[0], (SIMD_REG*)d2);
+          else              trid_solve_factored<REAL,VECTOR,INC>(rb, ra, rc, 1, (VECTOR*)&d[ind], (VECTOR*)&u[ind], sys_stride/SIMD_VEC, sys_size, (VECTOR*)d2);
+        } else {
+          if(solvedim == 0) trid_x_transpose_factored<REAL,0,INC>(&rb[ind], &ra[ind], &rc[ind], &d[ind], &u[ind], sys_size, plan->pads[0], (SIMD_REG*)d2);
+          else              trid_solve_factored<VECTOR,VECTOR,INC>((VECTOR*)&rb[ind], (VECTOR*)&ra[ind], (VECTOR*)&rc[ind], sys_stride/SIMD_VEC, (VECTOR*)&d[ind], (VECTOR*)&u[ind], sys_stride/SIMD_VEC, sys_size, (VECTOR*)d2);
+        }
+      } else {
+        // Leftover systems, and every system if d is not aligned. Interleaved x-factors are read with a stride of
+        // SIMD_VEC.
+        int  l    = lane_vec + j-nvec;
+        long find;
+        long fstr = sys_stride;
+        ind  += l*lane_stride;
+        find  = ind;
+        if(toeplitz) {
+          find = 0;
+          fstr = 1;
+        } else if(l < fact_vec) {
+          find = ind - (l%SIMD_VEC)*lane_stride + l%SIMD_VEC;
+          fstr = SIMD_VEC;
+        }
+        trid_solve_factored<REAL,REAL,INC>(&rb[find], &ra[find], &rc[find], fstr, &d[ind], &u[ind], sys_stride, sys_size, d2);
+      }
+    }
+  }
+}
+
+//
+// Solve a batch set up by trid_plan_init() and trid_plan_alloc() for nrhs right hand sides sharing the coefficients.
+// The right hand sides are stored one after the other, each in the layout of the coefficients. They are solved
+// NRHS_BLOCK at a time, every block with one elimination per system.
+//
+template<typename REAL, int INC>
+void trid_plan_solve_nrhs(const tridPlan_st *plan, const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u, int nrhs) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  typedef typename simd_traits<REAL>::reg    SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  const long  rhs_stride  = plan->cumpads[ndim];
+  const long  ws_part     = plan->ws_len / (1+NRHS_BLOCK);
+  const int   lane_vec    = is_simd_aligned(a, b, c, d, INC ? u : NULL, plan->pads[0]) ? plan->lane_vec : 0;
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    REAL *c2 = &((REAL*)plan->ws)[omp_get_thread_num()*plan->ws_len];
+    REAL *d2 = &c2[ws_part];
+
+    #pragma omp for collapse(2) schedule(static,1) nowait
+    for(long k=0; k<out_n; k++) {
+      for(int l=0; l<lane_vec; l+=SIMD_VEC) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        for(int r=0; r<nrhs; r+=NRHS_BLOCK) {
+          int  nr  = (nrhs-r < NRHS_BLOCK) ? nrhs-r : NRHS_BLOCK;
+          long rnd = ind + r*rhs_stride;
+          if(solvedim == 0) trid_x_transpose_nrhs<REAL,INC>(&a[ind], &b[ind], &c[ind], &d[rnd], &u[rnd], sys_size, plan->pads[0], nr, rhs_stride, (SIMD_REG*)c2, (SIMD_REG*)d2);
+          else              trid_scalar_nrhs<VECTOR,INC>((VECTOR*)&a[ind], (VECTOR*)&b[ind], (VECTOR*)&c[ind], (VECTOR*)&d[rnd], (VECTOR*)&u[rnd], sys_size, sys_stride/SIMD_VEC, nr, rhs_stride/SIMD_VEC, (VECTOR*)c2, (VECTOR*)d2);
+        }
+      }
+    }
+    // Leftover systems that don't fill a SIMD vector
+    #pragma omp for collapse(2) schedule(static,1)
+    for(long k=0; k<out_n; k++) {
+      for(int l=lane_vec; l<lane_n; l++) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        for(int r=0; r<nrhs; r+=NRHS_BLOCK) {
+          int  nr  = (nrhs-r < NRHS_BLOCK) ? nrhs-r : NRHS_BLOCK;
+          long rnd = ind + r*rhs_stride;
+          trid_scalar_nrhs<REAL,INC>(&a[ind], &b[ind], &c[ind], &d[rnd], &u[rnd], sys_size, sys_stride, nr, rhs_stride, c2, d2);
+        }
+      }
+    }
+  }
+}
+
+//
+// Solve a batch of periodic systems set up by trid_plan_init() and trid_plan_alloc() with three workspace parts. x-rows
+// are solved one system at a time, systems along the SIMD lanes of the other dimensions in vectors.
+//
+template<typename REAL, int INC>
+void trid_plan_solve_cyclic(const tridPlan_st *plan, const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  const long  ws_part     = plan->ws_len / 3;
+  const int   lane_vec    = (solvedim != 0 && is_simd_aligned(a, b, c, d, INC ? u : NULL, plan->pads[0])) ? plan->lane_vec : 0;
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    REAL *c2 = &((REAL*)plan->ws)[omp_get_thread_num()*plan->ws_len];
+    REAL *d2 = &c2[ws_part];
+    REAL *z2 = &d2[ws_part];
+
+    #pragma omp for collapse(2) schedule(static,1) nowait
+    for(long k=0; k<out_n; k++) {
+      for(int l=0; l<lane_vec; l+=SIMD_VEC) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        trid_cyclic<VECTOR,INC>((VECTOR*)&a[ind], (VECTOR*)&b[ind], (VECTOR*)&c[ind], (VECTOR*)&d[ind], (VECTOR*)&u[ind], sys_size, sys_stride/SIMD_VEC, (VECTOR*)c2, (VECTOR*)d2, (VECTOR*)z2);
+      }
+    }
+    // Leftover systems that don't fill a SIMD vector
+    #pragma omp for collapse(2) schedule(static,1)
+    for(long k=0; k<out_n; k++) {
+      for(int l=lane_vec; l<lane_n; l++) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        trid_cyclic<REAL,INC>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_stride, c2, d2, z2);
+      }
+    }
+  }
+}
+
+//
+// Solve a batch of mixed precision systems set up by trid_plan_init<float>() and trid_plan_alloc() with the workspace
+// parts of trid_plan_mixed_parts(): c', the pivot reciprocals and d' in float, and the solution in double taking two
+// parts. x-solves interleave a, b, c and d of SIMD_VEC rows into five more parts, so that they are solved in vectors
+// like the systems along the SIMD lanes of the other dimensions.
+//
+inline int trid_plan_mixed_parts(const tridPlan_st *plan) {
+  return 5 + (plan->solvedim == 0 ? 5 : 0);
+}
+
+template<int INC>
+void trid_plan_solve_mixed(const tridPlan_st *plan, const float* a, const float* b, const float* c, double* d, double* u, int nrefine) {
+  typedef simd_traits<float>::vector VECTOR;
+  const int SIMD_VEC = simd_traits<float>::vec;
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  const long  ws_part     = plan->ws_len / trid_plan_mixed_parts(plan);
+#ifdef TRID_SIMD_CONVERT
+  const int   lane_vec    = (is_simd_aligned(a, b, c, a, (float*)NULL, plan->pads[0]) &&
+                             is_simd_aligned(d, d, d, d, INC ? u : NULL, plan->pads[0])) ? plan->lane_vec : 0;
+#else
+  const int   lane_vec    = 0;
+#endif
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    float  *c2 = &((float*)plan->ws)[omp_get_thread_num()*plan->ws_len];
+    float  *b2 = &c2[ws_part];
+    float  *d2 = &b2[ws_part];
+    double *x  = (double*)&d2[ws_part];
+
+#ifdef TRID_SIMD_CONVERT
+    float  *xa = (float*)&x[ws_part];
+    float  *xb = &xa[ws_part];
+    float  *xc = &xb[ws_part];
+    double *xd = (double*)&xc[ws_part];
+    #pragma omp for collapse(2) schedule(static,1) nowait
+    for(long k=0; k<out_n; k++) {
+      for(int l=0; l<lane_vec; l+=SIMD_VEC) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        if(solvedim == 0) {
+          trid_x_interleave<float>(&a[ind], xa, sys_size, plan->pads[0], SIMD_VEC);
+          trid_x_interleave<float>(&b[ind], xb, sys_size, plan->pads[0], SIMD_VEC);
+          trid_x_interleave<float>(&c[ind], xc, sys_size, plan->pads[0], SIMD_VEC);
+          trid_x_interleave<double>(&d[ind], xd, sys_size, plan->pads[0], SIMD_VEC);
+          trid_mixed<VECTOR,mixed_vec,0>((VECTOR*)xa, (VECTOR*)xb, (VECTOR*)xc, (mixed_vec*)xd, NULL, sys_size, 1, nrefine, (VECTOR*)c2, (VECTOR*)b2, (VECTOR*)d2, (mixed_vec*)x);
+          if(INC) trid_x_deinterleave<double,1>(xd, &u[ind], sys_size, plan->pads[0], SIMD_VEC);
+          else    trid_x_deinterleave<double,0>(xd, &d[ind], sys_size, plan->pads[0], SIMD_VEC);
+        } else {
+          trid_mixed<VECTOR,mixed_vec,INC>((VECTOR*)&a[ind], (VECTOR*)&b[ind], (VECTOR*)&c[ind], (mixed_vec*)&d[ind], (mixed_vec*)&u[ind], sys_size, sys_stride/SIMD_VEC, nrefine, (VECTOR*)c2, (VECTOR*)b2, (VECTOR*)d2, (mixed_vec*)x);
+        }
+      }
+    }
+#endif
+    // Leftover systems that don't fill a SIMD vector
+    #pragma omp for collapse(2) schedule(static,1)
+    for(long k=0; k<out_n; k++) {
+      for(int l=lane_vec; l<lane_n; l++) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        trid_mixed<float,double,INC>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_stride, nrefine, c2, b2, d2, x);
+      }
+    }
+  }
+}
+
+//
+// Solve a batch with reduced precision coefficients set up by trid_plan_init() and trid_plan_alloc(). Besides c' and d'
+// the workspace of x-solves holds the converted coefficients of SIMD_VEC rows, see trid_plan_coef_parts().
+//
+inline int trid_plan_coef_parts(const tridPlan_st *plan) {
+  return 2 + (plan->solvedim == 0 ? 3*((plan->pads[0] + plan->sys_size-1) / plan->sys_size) : 0);
+}
+
+template<typename FMT, typename REAL, int INC>
+void trid_plan_solve_coef(const tridPlan_st *plan, const typename FMT::type* a, const typename FMT::type* b, const typename FMT::type* c, REAL* d, REAL* u) {
+  typedef typename simd_traits<REAL>::reg SIMD_REG;
+  typedef coef_scalar<FMT,REAL>           SCALAR;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  const long  ws_part     = plan->ws_len / trid_plan_coef_parts(plan);
+#ifdef TRID_SIMD_CONVERT
+  const int   lane_vec    = is_simd_aligned(d, d, d, d, INC ? u : NULL, plan->pads[0]) ? plan->lane_vec : 0; // Coefficients are loaded unaligned
+#else
+  const int   lane_vec    = 0;
+#endif
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    REAL *c2 = &((REAL*)plan->ws)[omp_get_thread_num()*plan->ws_len];
+    REAL *d2 = &c2[ws_part];
+
+#ifdef TRID_SIMD_CONVERT
+    typedef coef_vector<FMT,REAL>  VECTOR;
+    typedef typename VECTOR::type  VTYPE;
+    const long xrows = SIMD_VEC*plan->pads[0];
+    REAL *xa = &d2[ws_part];
+    REAL *xb = &xa[xrows];
+    REAL *xc = &xb[xrows];
+    #pragma omp for collapse(2) schedule(static,1) nowait
+    for(long k=0; k<out_n; k++) {
+      for(int l=0; l<lane_vec; l+=SIMD_VEC) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        if(solvedim == 0) {
+          trid_x_coef_rows<FMT,REAL>(&a[ind], xa, sys_size, plan->pads[0]);
+          trid_x_coef_rows<FMT,REAL>(&b[ind], xb, sys_size, plan->pads[0]);
+          trid_x_coef_rows<FMT,REAL>(&c[ind], xc, sys_size, plan->pads[0]);
+          trid_x_transpose<REAL,INC,0,0>(xa, xb, xc, &d[ind], &u[ind], sys_size, plan->pads[0], 1, SIMD_VEC, (SIMD_REG*)c2, (SIMD_REG*)d2);
+        } else {
+          trid_scalar_coef<VECTOR,REAL,INC>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_stride, (VTYPE*)c2, (VTYPE*)d2);
+        }
+      }
+    }
+#endif
+    // Leftover systems that don't fill a SIMD vector
+    #pragma omp for collapse(2) schedule(static,1)
+    for(long k=0; k<out_n; k++) {
+      for(int l=lane_vec; l<lane_n; l++) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        trid_scalar_coef<SCALAR,REAL,INC>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], sys_size, sys_stride, c2, d2);
+      }
+    }
+  }
+}
+
+//
+// Solve a batch of packed quadruples set up by trid_plan_init() and trid_plan_alloc(). Besides c' and d' the workspace
+// of x-solves holds the deinterleaved a, b, c and d of SIMD_VEC rows, see trid_plan_packed_parts().
+//
+inline int trid_plan_packed_parts(const tridPlan_st *plan) {
+  return 2 + (plan->solvedim == 0 ? 4*((plan->pads[0] + plan->sys_size-1) / plan->sys_size) : 0);
+}
+
+template<typename REAL, int INC>
+void trid_plan_solve_packed(const tridPlan_st *plan, REAL* p, REAL* u) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  typedef typename simd_traits<REAL>::reg    SIMD_REG;
+  const int SIMD_VEC = simd_traits<REAL>::vec;
+
+  const int   ndim        = plan->ndim;
+  const int   solvedim    = plan->solvedim;
+  const int   lanedim     = plan->lanedim;
+  const int   sys_size    = plan->sys_size;
+  const long  sys_stride  = plan->sys_stride;
+  const int   lane_n      = plan->lane_n;
+  const long  lane_stride = plan->lane_stride;
+  const long  out_n       = plan->out_n;
+  const long *outer       = plan->outer;
+  const long  ws_part     = plan->ws_len / trid_plan_packed_parts(plan);
+#ifdef TRID_SIMD_PACKED
+  const int   lane_vec    = is_simd_aligned(p, p, p, p, INC ? u : NULL, plan->pads[0]) ? plan->lane_vec : 0;
+#else
+  const int   lane_vec    = 0;
+#endif
+
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    REAL *c2 = &((REAL*)plan->ws)[omp_get_thread_num()*plan->ws_len];
+    REAL *d2 = &c2[ws_part];
+
+#ifdef TRID_SIMD_PACKED
+    const long xrows = SIMD_VEC*plan->pads[0];
+    REAL *xa = &d2[ws_part];
+    REAL *xb = &xa[xrows];
+    REAL *xc = &xb[xrows];
+    REAL *xd = &xc[xrows];
+    #pragma omp for collapse(2) schedule(static,1) nowait
+    for(long k=0; k<out_n; k++) {
+      for(int l=0; l<lane_vec; l+=SIMD_VEC) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        if(solvedim == 0) {
+          trid_x_packed_rows<REAL>(&p[4*ind], xa, xb, xc, xd, sys_size, plan->pads[0]);
+          trid_x_transpose<REAL,INC,0,0>(xa, xb, xc, xd, &u[ind], sys_size, plan->pads[0], 1, SIMD_VEC, (SIMD_REG*)c2, (SIMD_REG*)d2);
+          if(!INC) trid_x_packed_store<REAL>(&p[4*ind], xd, sys_size, plan->pads[0]);
+        } else {
+          trid_packed<REAL,VECTOR,INC>(&p[4*ind], &u[ind], sys_size, sys_stride, (VECTOR*)c2, (VECTOR*)d2);
+        }
+      }
+    }
+#endif
+    // Leftover systems that don't fill a SIMD vector
+    #pragma omp for collapse(2) schedule(static,1)
+    for(long k=0; k<out_n; k++) {
+      for(int l=lane_vec; l<lane_n; l++) {
+        long ind = (outer ? outer[k] : outer_offset(k, ndim, solvedim, lanedim, plan->dims, plan->cumpads)) + l*lane_stride;
+        trid_packed<REAL,REAL,INC>(&p[4*ind], &u[ind], sys_size, sys_stride, c2, d2);
+      }
+    }
+  }
+}
+
+//
+// Function for selecting the proper setup for solve in a specific dimension
+//
+template<typename REAL, int INC>
+tridStatus_t tridMultiDimBatchSolve(const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u, int ndim, int solvedim, int *dims, int *pads) {
+  tridPlan_st  plan;
+  tridStatus_t stat = trid_plan_init<REAL>(&plan, ndim, solvedim, dims, pads);
+  if(stat == TRID_STATUS_SUCCESS) stat = trid_plan_alloc<REAL>(&plan, 0, 1);
+  if(stat == TRID_STATUS_SUCCESS) trid_plan_solve<REAL,INC>(&plan, a, b, c, d, u);
+  trid_plan_free(&plan);
+  return stat;
+}
+
+template<typename REAL, int INC>
+tridStatus_t tridMultiDimBatchSolveNrhs(const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  if(nrhs < 1) return TRID_STATUS_INVALID_VALUE;
+  tridPlan_st  plan;
+  tridStatus_t stat = trid_plan_init<REAL>(&plan, ndim, solvedim, dims, pads);
+  plan.hybrid_chunks = 0; // The nrhs solve has no hybrid variant
+  if(stat == TRID_STATUS_SUCCESS) stat = trid_plan_alloc<REAL>(&plan, 0, NRHS_BLOCK);
+  if(stat == TRID_STATUS_SUCCESS) trid_plan_solve_nrhs<REAL,INC>(&plan, a, b, c, d, u, nrhs);
+  trid_plan_free(&plan);
+  return stat;
+}
+
+template<typename REAL, int INC>
+tridStatus_t tridMultiDimBatchSolveCyclic(const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u, int ndim, int solvedim, int *dims, int *pads) {
+  tridPlan_st  plan;
+  tridStatus_t stat = trid_plan_init<REAL>(&plan, ndim, solvedim, dims, pads);
+  if(stat == TRID_STATUS_SUCCESS && plan.sys_size < 2) stat = TRID_STATUS_INVALID_VALUE;
+  plan.hybrid_chunks = 0; // The cyclic solve has no hybrid variant
+  plan.x_compact     = 0;
+  if(stat == TRID_STATUS_SUCCESS) stat = trid_plan_alloc<REAL>(&plan, 0, 2); // c', d' and z'
+  if(stat == TRID_STATUS_SUCCESS) trid_plan_solve_cyclic<REAL,INC>(&plan, a, b, c, d, u);
+  trid_plan_free(&plan);
+  return stat;
+}
+
+template<int INC>
+tridStatus_t tridMultiDimBatchSolveMixed(const float* a, const float* b, const float* c, double* d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine) {
+  tridPlan_st  plan;
+  tridStatus_t stat = trid_plan_init<float>(&plan, ndim, solvedim, dims, pads);
+  if(stat == TRID_STATUS_SUCCESS && nrefine < 0) stat = TRID_STATUS_INVALID_VALUE;
+  plan.hybrid_chunks = 0; // Vectors of every other solver are of the precision of the plan
+  plan.x_compact     = 0;
+  plan.x_gather      = 0;
+  if(stat == TRID_STATUS_SUCCESS) stat = trid_plan_alloc<float>(&plan, 0, trid_plan_mixed_parts(&plan)-1);
+  if(stat == TRID_STATUS_SUCCESS) trid_plan_solve_mixed<INC>(&plan, a, b, c, d, u, nrefine);
+  trid_plan_free(&plan);
+  return stat;
+}
+
+template<typename FMT, typename REAL, int INC>
+tridStatus_t tridMultiDimBatchSolveCoef(const typename FMT::type* a, const typename FMT::type* b, const typename FMT::type* c, REAL* d, REAL* u, int ndim, int solvedim, int *dims, int *pads) {
+  tridPlan_st  plan;
+  tridStatus_t stat = trid_plan_init<REAL>(&plan, ndim, solvedim, dims, pads);
+  plan.hybrid_chunks = 0; // Only the kernels of trid_plan_solve_coef() convert coefficients
+  plan.x_compact     = 0;
+  plan.x_gather      = 0;
+  if(stat == TRID_STATUS_SUCCESS) stat = trid_plan_alloc<REAL>(&plan, 0, trid_plan_coef_parts(&plan)-1);
+  if(stat == TRID_STATUS_SUCCESS) trid_plan_solve_coef<FMT,REAL,INC>(&plan, a, b, c, d, u);
+  trid_plan_free(&plan);
+  return stat;
+}
+
+template<typename REAL, int INC>
+tridStatus_t tridMultiDimBatchSolvePacked(REAL* p, REAL* u, int ndim, int solvedim, int *dims, int *pads) {
+  tridPlan_st  plan;
+  tridStatus_t stat = trid_plan_init<REAL>(&plan, ndim, solvedim, dims, pads);
+  plan.hybrid_chunks = 0; // Only the kernels of trid_plan_solve_packed() read quadruples
+  plan.x_compact     = 0;
+  plan.x_gather      = 0;
+  if(stat == TRID_STATUS_SUCCESS) stat = trid_plan_alloc<REAL>(&plan, 0, trid_plan_packed_parts(&plan)-1);
+  if(stat == TRID_STATUS_SUCCESS) trid_plan_solve_packed<REAL,INC>(&plan, p, u);
+  trid_plan_free(&plan);
+  return stat;
+}
+
+//
+// Solve nsys interleaved systems of N rows, element i of system s at i*nsys_pad + s. Each thread solves a contiguous
+// range of systems, so that no two threads write the same cache line.
+//
+template<typename REAL, int INC>
+tridStatus_t tridInterleavedBatchSolve(const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u, int N, int nsys, int nsys_pad) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+  const int G          = SIMD_WIDTH >= 64 ? 2 : 4; // Vectors solved together by trid_interleaved(), two cache lines
+
+  if(N < 1 || nsys < 1 || nsys_pad < nsys) return TRID_STATUS_INVALID_VALUE;
+
+  const int  nvec     = is_simd_aligned(a, b, c, d, INC ? u : NULL, nsys_pad) ? nsys/SIMD_VEC : 0;
+  const int  nthreads = omp_get_max_threads();
+  const long ws_len   = 2L*G*SIMD_VEC*N; // c' and d' of G vectors
+  REAL      *ws       = (REAL*)_mm_malloc(sizeof(REAL)*ws_len*nthreads, SIMD_WIDTH);
+  if(ws == NULL) return TRID_STATUS_ALLOC_FAILED;
+
+  #pragma omp parallel num_threads(nthreads)
+  {
+    VECTOR *c2 = (VECTOR*)&ws[omp_get_thread_num()*ws_len];
+    VECTOR *d2 = &c2[G*N];
+
+    #pragma omp for schedule(static) nowait
+    for(int v=0; v<nvec/G; v++) {
+      long ind = (long)v*G*SIMD_VEC;
+      trid_interleaved<REAL,INC,G>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], N, nsys_pad, c2, d2);
+    }
+    #pragma omp for schedule(static) nowait
+    for(int v=nvec/G*G; v<nvec; v++) {
+      long ind = (long)v*SIMD_VEC;
+      trid_interleaved<REAL,INC,1>(&a[ind], &b[ind], &c[ind], &d[ind], &u[ind], N, nsys_pad, c2, d2);
+    }
+    // Leftover systems that don't fill a SIMD vector
+    #pragma omp for schedule(static)
+    for(int s=nvec*SIMD_VEC; s<nsys; s++) {
+      trid_scalar<REAL,INC>(&a[s], &b[s], &c[s], &d[s], &u[s], N, nsys_pad, (REAL*)c2, (REAL*)d2);
+    }
+  }
+  _mm_free(ws);
+  return TRID_STATUS_SUCCESS;
+}
+
+template<typename REAL>
+tridStatus_t tridConvertInterleaved(const REAL* src, REAL* dst, int rows, int cols, int src_pad, int dst_pad) {
+  if(rows < 1 || cols < 1 || src_pad < cols || dst_pad < rows) return TRID_STATUS_INVALID_VALUE;
+  trid_transpose<REAL>(src, dst, rows, cols, src_pad, dst_pad);
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// Ragged batch: system s has lengths[s] contiguous rows starting at offsets[s]. order lists the systems longest first
+// (sorted by the dispatcher, see trid_cpu_dispatch.cpp); they are packed SIMD_VEC at a time into the lanes of
+// trid_ragged(), so the lanes of a vector have similar lengths and few identity rows are solved. Vectors are handed
+// out longest first by schedule(dynamic), which balances the threads.
+//
+template<typename REAL, int INC>
+tridStatus_t tridRaggedBatchSolve(const REAL* a, const REAL* b, const REAL* c, REAL* d, REAL* u, const long* offsets, const int* lengths, const int* order, int nsys) {
+  typedef typename simd_traits<REAL>::vector VECTOR;
+  const int SIMD_WIDTH = simd_traits<REAL>::width;
+  const int SIMD_VEC   = simd_traits<REAL>::vec;
+
+  const int  nvec     = (nsys + SIMD_VEC-1) / SIMD_VEC;
+  const int  nthreads = omp_get_max_threads();
+  const long ws_len   = 2L*SIMD_VEC*lengths[order[0]]; // c' and d' of the longest system
+  REAL      *ws       = (REAL*)_mm_malloc(sizeof(REAL)*ws_len*nthreads, SIMD_WIDTH);
+  if(ws == NULL) return TRID_STATUS_ALLOC_FAILED;
+
+  #pragma omp parallel num_threads(nthreads)
+  {
+    VECTOR *c2 = (VECTOR*)&ws[omp_get_thread_num()*ws_len];
+    VECTOR *d2 = &c2[ws_len/(2*SIMD_VEC)];
+    long    off[SIMD_VEC];
+    int     len[SIMD_VEC];
+
+    #pragma omp for schedule(dynamic)
+    for(int v=0; v<nvec; v++) {
+      for(int j=0; j<SIMD_VEC; j++) {
+        int s  = v*SIMD_VEC + j;
+        off[j] = s < nsys ? offsets[order[s]] : 0;
+        len[j] = s < nsys ? lengths[order[s]] : 0;
+      }
+      trid_ragged<REAL,INC>(a, b, c, d, u, off, len, len[0], c2, d2);
+    }
+  }
+  _mm_free(ws);
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// System-to-thread partition of trid_plan_solve() with arrays aligned for the SIMD kernels. The work items of a system
+// row, first the SIMD ones of step systems along the lanes and then the leftover systems, are numbered row by row and
+// every thread takes a contiguous block of them, see trid_static_block(). Plans of the hybrid solver split their
+// systems between threads instead, see tridPlanFirstTouch().
+//
+template<typename REAL>
+struct trid_partition {
+  int  lane_simd; // Systems along the lanes solved in SIMD work items
+  int  step;      // Systems of a SIMD work item
+  long nvec;      // SIMD work items per system row
+  long nleft;     // Leftover systems per system row
+
+  trid_partition(const tridPlan_st *plan) {
+    const int SIMD_VEC = simd_traits<REAL>::vec;
+    const int x_gather = plan->x_gather == 2 || (plan->x_gather == 1 && plan->lane_vec == 0);
+    lane_simd = trid_plan_lane_simd<REAL>(plan, 1, x_gather);
+    step      = SIMD_VEC;
+    nvec      = (lane_simd + step-1) / step;
+    nleft     = plan->lane_n - lane_simd;
+  }
+};
+
+// Call f with the offset of the first element of every system solved by a thread
+template<typename REAL, typename F>
+void trid_plan_thread_systems(const tridPlan_st *plan, int thread, F &f) {
+  const trid_partition<REAL> part(plan);
+  const long nitems = part.nvec + part.nleft;
+  long beg, end;
+  trid_static_block(plan->out_n*nitems, thread, plan->nthreads, &beg, &end);
+  for(long it=beg; it<end; it++) {
+    long k   = it / nitems;
+    long j   = it % nitems;
+    long ind = plan->outer ? plan->outer[k] : outer_offset(k, plan->ndim, plan->solvedim, plan->lanedim, plan->dims, plan->cumpads);
+    if(j < part.nvec) {
+      for(int l=j*part.step; l<(j+1)*part.step && l<part.lane_simd; l++) f(ind + l*plan->lane_stride);
+    } else {
+      f(ind + (part.lane_simd + j-part.nvec)*plan->lane_stride);
+    }
+  }
+}
+
+struct trid_partition_list {
+  long *offsets;
+  long  cap;
+  long  n;
+  void operator()(long ind) {
+    if(offsets != NULL && n < cap) offsets[n] = ind;
+    n++;
+  }
+};
+
+template<typename REAL>
+struct trid_partition_touch {
+  REAL *array;
+  int   sys_size;
+  long  sys_stride;
+  void operator()(long ind) {
+    for(int i=0; i<sys_size; i++) array[ind + i*sys_stride] = 0;
+  }
+};
+
+//
+// Elements of the systems of a thread on every page of page_bytes from base, and the offset of the first of them, so
+// that the thread with the most elements on a huge page can touch it first
+//
+template<typename REAL>
+struct trid_partition_owner {
+  REAL     *array;
+  int       sys_size;
+  long      sys_stride;
+  uintptr_t base;
+  long      page_bytes;
+  long     *count;
+  long     *first;
+  void operator()(long ind) {
+    for(int i=0; i<sys_size; i++) {
+      long off = ind + i*sys_stride;
+      long p   = ((uintptr_t)&array[off] - base) / page_bytes;
+      if(count[p]++ == 0) first[p] = off;
+    }
+  }
+};
+
+//
+// Size of the pages backing the memory at p: that of a hugetlbfs mapping, 2 MB for a mapping that may be backed by
+// transparent huge pages, as those of tridMalloc() are, and TOUCH_PAGE_BYTES otherwise. Read from the entry of the
+// mapping in /proc/self/smaps, so TOUCH_PAGE_BYTES off Linux.
+//
+inline long trid_page_bytes(const void *p) {
+  long bytes = TOUCH_PAGE_BYTES;
+#ifdef __linux__
+  FILE *f = fopen("/proc/self/smaps", "r");
+  if(f == NULL) return bytes;
+  char          line[512];
+  int           found = 0;
+  unsigned long beg, end;
+  long          kb;
+  int           thp;
+  while(fgets(line, sizeof(line), f) != NULL) {
+    if(sscanf(line, "%lx-%lx ", &beg, &end) == 2) { // First line of a mapping
+      if(found) break;
+      found = (uintptr_t)p >= beg && (uintptr_t)p < end;
+    } else if(found && sscanf(line, "KernelPageSize: %ld kB", &kb) == 1) {
+      if(kb*1024 > bytes) bytes = kb*1024;
+    } else if(found && sscanf(line, "THPeligible: %d", &thp) == 1) {
+      if(thp == 1 && HUGE_PAGE_BYTES > bytes) bytes = HUGE_PAGE_BYTES;
+    }
+  }
+  fclose(f);
+#endif
+  return bytes;
+}
+
+//
+// Pages holding the elements a thread reads, with the number of elements on them. Consecutive elements on the same
+// page are counted once, so rows of a SIMD work item add one page each. With pages NULL only n is counted, so the
+// arrays can be allocated for a second pass.
+//
+struct trid_partition_pages {
+  const char  *array;
+  int          real_size;
+  int          sys_size;
+  long         sys_stride;
+  void       **pages;
+  long        *counts;
+  long         n;
+  void        *last;
+  void operator()(long ind) {
+    for(int i=0; i<sys_size; i++) {
+      void *page = (void*)(((uintptr_t)&array[(ind + i*sys_stride)*real_size]) & ~(uintptr_t)(TOUCH_PAGE_BYTES-1));
+      if(n == 0 || last != page) {
+        if(pages != NULL) {
+          pages[n]  = page;
+          counts[n] = 0;
+        }
+        last = page;
+        n++;
+      }
+      if(counts != NULL) counts[n-1]++;
+    }
+  }
+};
+
+template<typename REAL>
+tridStatus_t trid_plan_partition(const tridPlan_st *plan, int thread, long *offsets, long *nsys) {
+  trid_partition_list list = { offsets, *nsys, 0 };
+  trid_plan_thread_systems<REAL>(plan, thread, list);
+  *nsys = list.n;
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// With policy 0 every thread zeroes its own systems. Huge pages are first touched beforehand by the thread with the
+// most elements on them, ties going round robin, since the first write to any element places the whole page.
+//
+template<typename REAL>
+tridStatus_t trid_plan_first_touch(const tridPlan_st *plan, REAL *array, int policy) {
+  if(policy == 0 && plan->hybrid_chunks == 0) {
+    const int       nthreads   = plan->nthreads;
+    const long      page_bytes = trid_page_bytes(array);
+    const uintptr_t base       = (uintptr_t)array & ~(uintptr_t)(page_bytes-1);
+    const long      npages     = ((uintptr_t)&array[plan->cumpads[plan->ndim]-1] - base) / page_bytes + 1;
+    long           *count      = NULL; // Elements of every thread on every huge page, then the first of them
+    if(page_bytes > TOUCH_PAGE_BYTES) {
+      count = (long*) calloc(2L*nthreads*npages, sizeof(long));
+      if(count == NULL) return TRID_STATUS_ALLOC_FAILED;
+    }
+    #pragma omp parallel num_threads(nthreads)
+    {
+      const int thread = omp_get_thread_num();
+      if(count != NULL) {
+        trid_partition_owner<REAL> owner = { array, plan->sys_size, plan->sys_stride, base, page_bytes, &count[thread*npages], &count[(nthreads+thread)*npages] };
+        trid_plan_thread_systems<REAL>(plan, thread, owner);
+        #pragma omp barrier
+        for(long p=0; p<npages; p++) {
+          int  o    = -1;
+          long most = 0;
+          for(int i=0; i<nthreads; i++) {
+            int t = (p+i) % nthreads;
+            if(count[t*npages+p] > most) {
+              most = count[t*npages+p];
+              o    = t;
+            }
+          }
+          if(o == thread) array[count[(nthreads+thread)*npages+p]] = 0;
+        }
+        #pragma omp barrier
+      }
+      trid_partition_touch<REAL> touch = { array, plan->sys_size, plan->sys_stride };
+      trid_plan_thread_systems<REAL>(plan, thread, touch);
+    }
+    free(count);
+  } else {
+    const long len    = plan->cumpads[plan->ndim];
+    const long npages = (len*sizeof(REAL) + INTERLEAVE_BYTES-1) / INTERLEAVE_BYTES;
+    const long step   = INTERLEAVE_BYTES / sizeof(REAL);
+    #pragma omp parallel for schedule(static,1) num_threads(plan->nthreads)
+    for(long p=0; p<npages; p++) {
+      long end = (p+1)*step < len ? (p+1)*step : len;
+      for(long i=p*step; i<end; i++) array[i] = 0;
+    }
+  }
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// Count the elements every thread reads from the memory of its own NUMA node and from other nodes, by asking the
+// kernel where the pages are with move_pages() and where the thread runs with getcpu(). Pages that haven't been
+// touched yet aren't counted.
+//
+template<typename REAL>
+tridStatus_t trid_plan_locality(const tridPlan_st *plan, const REAL *array, int nnodes, long *local, long *remote) {
+#if defined(__linux__) && defined(SYS_move_pages) && defined(SYS_getcpu)
+  for(int n=0; n<nnodes; n++) {
+    local[n]  = 0;
+    remote[n] = 0;
+  }
+  int failed = 0;
+  #pragma omp parallel num_threads(plan->nthreads)
+  {
+    unsigned cpu, node;
+    if(syscall(SYS_getcpu, &cpu, &node, NULL) != 0) node = 0;
+    trid_partition_pages pages = { (const char*)array, sizeof(REAL), plan->sys_size, plan->sys_stride, NULL, NULL, 0, NULL };
+    trid_plan_thread_systems<REAL>(plan, omp_get_thread_num(), pages); // Count the pages
+    const long npages = pages.n;
+    char      *buf    = (char*)malloc((sizeof(void*) + sizeof(long))*npages + sizeof(int)*LOCALITY_QUERY);
+
+    long nlocal = 0, nremote = 0;
+    if(buf == NULL) {
+      #pragma omp atomic write
+      failed = 1;
+    } else {
+      pages.pages  = (void**)buf;
+      pages.counts = (long*)&pages.pages[npages];
+      pages.n      = 0;
+      int *status  = (int*)&pages.counts[npages];
+      trid_plan_thread_systems<REAL>(plan, omp_get_thread_num(), pages);
+      for(long beg=0; beg<npages; beg+=LOCALITY_QUERY) {
+        long n = npages-beg < LOCALITY_QUERY ? npages-beg : LOCALITY_QUERY;
+        if(syscall(SYS_move_pages, 0, n, &pages.pages[beg], NULL, status, 0) != 0) {
+          #pragma omp atomic write
+          failed = 1;
+          break;
+        }
+        for(long i=0; i<n; i++) {
+          if(status[i] < 0) continue; // Not touched yet
+          if((unsigned)status[i] == node) nlocal  += pages.counts[beg+i];
+          else                           nremote += pages.counts[beg+i];
+        }
+      }
+      free(buf);
+    }
+    if(node < (unsigned)nnodes) {
+      #pragma omp atomic
+      local[node]  += nlocal;
+      #pragma omp atomic
+      remote[node] += nremote;
+    }
+  }
+  return failed ? TRID_STATUS_EXECUTION_FAILED : TRID_STATUS_SUCCESS;
+#else
+  return TRID_STATUS_ARCH_MISMATCH;
+#endif
+}
+
+//
+// Plan with the geometry, the row offset table and the workspace of a batch kept between executions
+//
+template<typename REAL>
+tridStatus_t tridPlanCreate(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads) {
+  if(plan == NULL) return TRID_STATUS_INVALID_VALUE;
+  *plan = NULL;
+  tridPlan_st *p = (tridPlan_st*) malloc(sizeof(tridPlan_st));
+  if(p == NULL) return TRID_STATUS_ALLOC_FAILED;
+  tridStatus_t stat = trid_plan_init<REAL>(p, ndim, solvedim, dims, pads);
+  if(stat == TRID_STATUS_SUCCESS) stat = trid_plan_alloc<REAL>(p, 1, 1);
+  if(stat != TRID_STATUS_SUCCESS) {
+    trid_plan_free(p);
+    free(p);
+    return stat;
+  }
+  p->kernels = &kernels;
+  *plan      = p;
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridSmtsvStridedBatch(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolve<float,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolve<float,1>(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchNrhs(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return tridMultiDimBatchSolveNrhs<float,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridSmtsvStridedBatchNrhsInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return tridMultiDimBatchSolveNrhs<float,1>(a, b, c, d, u, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridSmtsvStridedBatchCyclic(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCyclic<float,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCyclicInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCyclic<float,1>(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvPlanCreate(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads) {
+  return tridPlanCreate<float>(plan, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvPlanExecute(tridPlan_t plan, const float *a, const float *b, const float *c, float *d, float *u) {
+  trid_plan_solve<float,0>(plan, a, b, c, d, NULL);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridSmtsvPlanExecuteInc(tridPlan_t plan, const float *a, const float *b, const float *c, float *d, float *u) {
+  trid_plan_solve<float,1>(plan, a, b, c, d, u);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridSmtsvPlanFactorize(tridPlan_t plan, const float *a, const float *b, const float *c) {
+  return trid_plan_factor<float>(plan, a, b, c);
+}
+
+tridStatus_t tridSmtsvPlanFactorizeToeplitz(tridPlan_t plan, float a, float b, float c, float b0, float c0, float an, float bn) {
+  return trid_plan_factor_toeplitz<float>(plan, a, b, c, b0, c0, an, bn);
+}
+
+tridStatus_t tridSmtsvPlanSolve(tridPlan_t plan, float *d, float *u) {
+  trid_plan_solve_factored<float,0>(plan, d, NULL);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridSmtsvPlanSolveInc(tridPlan_t plan, float *d, float *u) {
+  trid_plan_solve_factored<float,1>(plan, d, u);
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+//int* get_opts() {return opts;}
+
+
+
+
+
+void trid_scalarS(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int N, int stride) {
+  
+  float *ws = (float*) _mm_malloc(2*sizeof(float)*N, simd_traits<float>::width);
+  trid_scalar<float,0>(a, b, c, d, u, N, stride, ws, &ws[N]);
+  _mm_free(ws);
+  
+}
+
+void trid_x_transposeS(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int sys_size, int sys_pad, int stride) {
+
+  simd_traits<float>::reg *ws = (simd_traits<float>::reg*) _mm_malloc(2*sizeof(simd_traits<float>::reg)*sys_size, simd_traits<float>::width);
+  trid_x_transpose<float,0,0,0>(a, b, c, d, u, sys_size, sys_pad, stride, simd_traits<float>::vec, ws, &ws[sys_size]);
+  _mm_free(ws);
+
+}
+
+void trid_scalar_vecS(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int N, int stride) {
+
+  simd_traits<float>::vector *ws = (simd_traits<float>::vector*) _mm_malloc(2*sizeof(simd_traits<float>::vector)*N, simd_traits<float>::width);
+  trid_scalar_vec<float,simd_traits<float>::vector,0,0>(a, b, c, d, u, N, stride, ws, &ws[N]);
+  _mm_free(ws);
+
+}
+
+void trid_scalar_vecSInc(float* __restrict a, float* __restrict b, float* __restrict c, float* __restrict d, float* __restrict u, int N, int stride) {
+
+  simd_traits<float>::vector *ws = (simd_traits<float>::vector*) _mm_malloc(2*sizeof(simd_traits<float>::vector)*N, simd_traits<float>::width);
+  trid_scalar_vec<float,simd_traits<float>::vector,1,0>(a, b, c, d, u, N, stride, ws, &ws[N]);
+  _mm_free(ws);
+
+}
+
+tridStatus_t tridDmtsvStridedBatch(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolve<double,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolve<double,1>(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchNrhs(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return tridMultiDimBatchSolveNrhs<double,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridDmtsvStridedBatchNrhsInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return tridMultiDimBatchSolveNrhs<double,1>(a, b, c, d, u, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridDmtsvStridedBatchCyclic(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCyclic<double,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchCyclicInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCyclic<double,1>(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchMixed(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine) {
+  return tridMultiDimBatchSolveMixed<0>(a, b, c, d, NULL, ndim, solvedim, dims, pads, nrefine);
+}
+
+tridStatus_t tridDmtsvStridedBatchMixedInc(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine) {
+  return tridMultiDimBatchSolveMixed<1>(a, b, c, d, u, ndim, solvedim, dims, pads, nrefine);
+}
+
+tridStatus_t tridSmtsvStridedBatchCoefF16(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCoef<coef_f16,float,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCoefF16Inc(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCoef<coef_f16,float,1>(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCoefBF16(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCoef<coef_bf16,float,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCoefBF16Inc(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCoef<coef_bf16,float,1>(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchCoefF32(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCoef<coef_f32,double,0>(a, b, c, d, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchCoefF32Inc(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolveCoef<coef_f32,double,1>(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchPacked(float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolvePacked<float,0>(abcd, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchPackedInc(const float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolvePacked<float,1>((float*)abcd, u, ndim, solvedim, dims, pads); // Quadruples are only read
+}
+
+tridStatus_t tridDmtsvStridedBatchPacked(double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolvePacked<double,0>(abcd, NULL, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchPackedInc(const double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads) {
+  return tridMultiDimBatchSolvePacked<double,1>((double*)abcd, u, ndim, solvedim, dims, pads); // Quadruples are only read
+}
+
+tridStatus_t tridSgtsvInterleavedBatch(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int nsys_pad) {
+  return tridInterleavedBatchSolve<float,0>(a, b, c, d, NULL, N, nsys, nsys_pad);
+}
+
+tridStatus_t tridSgtsvInterleavedBatchInc(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int nsys_pad) {
+  return tridInterleavedBatchSolve<float,1>(a, b, c, d, u, N, nsys, nsys_pad);
+}
+
+tridStatus_t tridSconvertToInterleaved(const float *src, float *dst, int N, int nsys, int sys_pad, int nsys_pad) {
+  return tridConvertInterleaved<float>(src, dst, nsys, N, sys_pad, nsys_pad);
+}
+
+tridStatus_t tridSconvertFromInterleaved(const float *src, float *dst, int N, int nsys, int nsys_pad, int sys_pad) {
+  return tridConvertInterleaved<float>(src, dst, N, nsys, nsys_pad, sys_pad);
+}
+
+tridStatus_t tridDgtsvInterleavedBatch(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int nsys_pad) {
+  return tridInterleavedBatchSolve<double,0>(a, b, c, d, NULL, N, nsys, nsys_pad);
+}
+
+tridStatus_t tridDgtsvInterleavedBatchInc(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int nsys_pad) {
+  return tridInterleavedBatchSolve<double,1>(a, b, c, d, u, N, nsys, nsys_pad);
+}
+
+tridStatus_t tridSgtsvRaggedBatch(const float *a, const float *b, const float *c, float *d, float *u, const long *offsets, const int *lengths, const int *order, int nsys) {
+  return tridRaggedBatchSolve<float,0>(a, b, c, d, NULL, offsets, lengths, order, nsys);
+}
+
+tridStatus_t tridSgtsvRaggedBatchInc(const float *a, const float *b, const float *c, float *d, float *u, const long *offsets, const int *lengths, const int *order, int nsys) {
+  return tridRaggedBatchSolve<float,1>(a, b, c, d, u, offsets, lengths, order, nsys);
+}
+
+tridStatus_t tridDgtsvRaggedBatch(const double *a, const double *b, const double *c, double *d, double *u, const long *offsets, const int *lengths, const int *order, int nsys) {
+  return tridRaggedBatchSolve<double,0>(a, b, c, d, NULL, offsets, lengths, order, nsys);
+}
+
+tridStatus_t tridDgtsvRaggedBatchInc(const double *a, const double *b, const double *c, double *d, double *u, const long *offsets, const int *lengths, const int *order, int nsys) {
+  return tridRaggedBatchSolve<double,1>(a, b, c, d, u, offsets, lengths, order, nsys);
+}
+
+tridStatus_t tridDconvertToInterleaved(const double *src, double *dst, int N, int nsys, int sys_pad, int nsys_pad) {
+  return tridConvertInterleaved<double>(src, dst, nsys, N, sys_pad, nsys_pad);
+}
+
+tridStatus_t tridDconvertFromInterleaved(const double *src, double *dst, int N, int nsys, int nsys_pad, int sys_pad) {
+  return tridConvertInterleaved<double>(src, dst, N, nsys, nsys_pad, sys_pad);
+}
+
+tridStatus_t tridDmtsvPlanCreate(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads) {
+  return tridPlanCreate<double>(plan, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvPlanExecute(tridPlan_t plan, const double *a, const double *b, const double *c, double *d, double *u) {
+  trid_plan_solve<double,0>(plan, a, b, c, d, NULL);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridDmtsvPlanExecuteInc(tridPlan_t plan, const double *a, const double *b, const double *c, double *d, double *u) {
+  trid_plan_solve<double,1>(plan, a, b, c, d, u);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridDmtsvPlanFactorize(tridPlan_t plan, const double *a, const double *b, const double *c) {
+  return trid_plan_factor<double>(plan, a, b, c);
+}
+
+tridStatus_t tridDmtsvPlanFactorizeToeplitz(tridPlan_t plan, double a, double b, double c, double b0, double c0, double an, double bn) {
+  return trid_plan_factor_toeplitz<double>(plan, a, b, c, b0, c0, an, bn);
+}
+
+tridStatus_t tridDmtsvPlanSolve(tridPlan_t plan, double *d, double *u) {
+  trid_plan_solve_factored<double,0>(plan, d, NULL);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridDmtsvPlanSolveInc(tridPlan_t plan, double *d, double *u) {
+  trid_plan_solve_factored<double,1>(plan, d, u);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridPlanDestroy(tridPlan_t plan) {
+  trid_plan_free(plan);
+  free(plan);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridPlanGetPartition(tridPlan_t plan, int thread, long *offsets, long *nsys) {
+  if(plan->real_size == sizeof(float)) return trid_plan_partition<float>(plan, thread, offsets, nsys);
+  else                                 return trid_plan_partition<double>(plan, thread, offsets, nsys);
+}
+
+tridStatus_t tridPlanFirstTouch(tridPlan_t plan, void *array, int policy) {
+  if(plan->real_size == sizeof(float)) return trid_plan_first_touch<float>(plan, (float*)array, policy);
+  else                                 return trid_plan_first_touch<double>(plan, (double*)array, policy);
+}
+
+tridStatus_t tridPlanGetLocality(tridPlan_t plan, const void *array, int nnodes, long *local, long *remote) {
+  if(plan->real_size == sizeof(float)) return trid_plan_locality<float>(plan, (const float*)array, nnodes, local, remote);
+  else                                 return trid_plan_locality<double>(plan, (const double*)array, nnodes, local, remote);
+}
+
+void trid_scalarD(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int N, int stride) {
+  
+  double *ws = (double*) _mm_malloc(2*sizeof(double)*N, simd_traits<double>::width);
+  trid_scalar<double,0>(a, b, c, d, u, N, stride, ws, &ws[N]);
+  _mm_free(ws);
+
+}
+
+void trid_x_transposeD(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int sys_size, int sys_pad, int stride) {
+
+  simd_traits<double>::reg *ws = (simd_traits<double>::reg*) _mm_malloc(2*sizeof(simd_traits<double>::reg)*sys_size, simd_traits<double>::width);
+  trid_x_transpose<double,0,0,0>(a, b, c, d, u, sys_size, sys_pad, stride, simd_traits<double>::vec, ws, &ws[sys_size]);
+  _mm_free(ws);
+
+}
+
+void trid_scalar_vecD(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int N, int stride) {
+
+  simd_traits<double>::vector *ws = (simd_traits<double>::vector*) _mm_malloc(2*sizeof(simd_traits<double>::vector)*N, simd_traits<double>::width);
+  trid_scalar_vec<double,simd_traits<double>::vector,0,0>(a, b, c, d, u, N, stride, ws, &ws[N]);
+  _mm_free(ws);
+
+}
+
+void trid_scalar_vecDInc(double* __restrict a, double* __restrict b, double* __restrict c, double* __restrict d, double* __restrict u, int N, int stride) {
+
+  simd_traits<double>::vector *ws = (simd_traits<double>::vector*) _mm_malloc(2*sizeof(simd_traits<double>::vector)*N, simd_traits<double>::width);
+  trid_scalar_vec<double,simd_traits<double>::vector,1,0>(a, b, c, d, u, N, stride, ws, &ws[N]);
+  _mm_free(ws);
+
+}
 
+extern const trid_cpu_kernels kernels = {
+  simd_traits<float>::width,
+  tridSmtsvStridedBatch, tridSmtsvStridedBatchInc, trid_scalarS, trid_x_transposeS, trid_scalar_vecS, trid_scalar_vecSInc,
+  tridDmtsvStridedBatch, tridDmtsvStridedBatchInc, trid_scalarD, trid_x_transposeD, trid_scalar_vecD, trid_scalar_vecDInc,
+  tridSmtsvPlanCreate, tridSmtsvPlanExecute, tridSmtsvPlanExecuteInc,
+  tridDmtsvPlanCreate, tridDmtsvPlanExecute, tridDmtsvPlanExecuteInc,
+  tridPlanDestroy,
+  tridPlanGetPartition, tridPlanFirstTouch, tridPlanGetLocality,
+  tridSmtsvPlanFactorize, tridSmtsvPlanSolve, tridSmtsvPlanSolveInc,
+  tridDmtsvPlanFactorize, tridDmtsvPlanSolve, tridDmtsvPlanSolveInc,
+  tridSmtsvPlanFactorizeToeplitz, tridDmtsvPlanFactorizeToeplitz,
+  tridSmtsvStridedBatchNrhs, tridSmtsvStridedBatchNrhsInc, tridDmtsvStridedBatchNrhs, tridDmtsvStridedBatchNrhsInc,
+  tridSmtsvStridedBatchCyclic, tridSmtsvStridedBatchCyclicInc, tridDmtsvStridedBatchCyclic, tridDmtsvStridedBatchCyclicInc,
+  tridDmtsvStridedBatchMixed, tridDmtsvStridedBatchMixedInc,
+  tridSmtsvStridedBatchCoefF16, tridSmtsvStridedBatchCoefF16Inc, tridSmtsvStridedBatchCoefBF16, tridSmtsvStridedBatchCoefBF16Inc,
+  tridDmtsvStridedBatchCoefF32, tridDmtsvStridedBatchCoefF32Inc,
+  tridSgtsvInterleavedBatch, tridSgtsvInterleavedBatchInc, tridDgtsvInterleavedBatch, tridDgtsvInterleavedBatchInc,
+  tridSconvertToInterleaved, tridSconvertFromInterleaved, tridDconvertToInterleaved, tridDconvertFromInterleaved,
+  tridSmtsvStridedBatchPacked, tridSmtsvStridedBatchPackedInc, tridDmtsvStridedBatchPacked, tridDmtsvStridedBatchPackedInc,
+  tridSgtsvRaggedBatch, tridSgtsvRaggedBatchInc, tridDgtsvRaggedBatch, tridDgtsvRaggedBatchInc
+};
+
+} // namespace TRID_ISA_NS
@@ -0,0 +1,144 @@
+/*
+ * Open source copyright declaration based on BSD open source template:
+ * http://www.opensource.org/licenses/bsd-license.php
+ *
+ * This file is part of the scalar-tridiagonal solver distribution.
+ *
+ * Copyright (c) 2015, Endre László and others. Please see the AUTHORS file in
+ * the main source directory for a full list of copyright holders.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * The name of Endre László may not be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Endre László ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Endre László BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Allocator for the arrays of the solvers. Buffers of 2 MB or more are backed by huge pages, so that the strided
+// sweeps of the y- and z-solves over large grids don't miss the TLB on every row: one TLB entry then covers 512 times
+// as many rows of a system as with 4 kB pages.
+//
+// The allocator doesn't depend on the vector ISA, so this file is compiled for the baseline architecture.
+//
+#include <stdlib.h>
+#include <stdint.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#include "trid_cpu.h"
+
+#define ALLOC_ALIGN     64        // Alignment and padding of the buffers: the widest SIMD vector and a cache line
+#define HUGE_PAGE_BYTES (2L<<20)  // Huge page size of x86-64
+#define ALLOC_COLOURS   8         // Different offsets of huge page buffers from the page boundary
+#define ALLOC_COLOUR    (65*ALLOC_ALIGN) // Offset step: one cache line more than a 4 kB page
+#define ROUND_UP(N,step) ((((N)+(step)-1)/(step))*(step))
+
+// Bookkeeping stored in the ALLOC_ALIGN bytes in front of every buffer
+struct trid_alloc_header {
+  void  *base;   // Start of the allocation
+  size_t len;    // Length of the mapping
+  int    mapped; // Allocated with mmap() rather than posix_memalign()
+};
+
+//
+// TRID_CPU_HUGEPAGES=<0|1|2> selects no huge pages, transparent huge pages (default) or explicit huge pages from the
+// hugetlbfs pool, with transparent ones as the fallback when the pool is exhausted
+//
+static int huge_page_mode() {
+  const char *env = getenv("TRID_CPU_HUGEPAGES");
+  int mode = (env != NULL) ? atoi(env) : 1;
+  if(mode < 0) mode = 0;
+  if(mode > 2) mode = 2;
+  return mode;
+}
+
+//
+// Within a huge page consecutive virtual addresses are consecutive physical ones, so buffers starting at the same
+// offset from a huge page boundary map their elements to the same cache sets and the same 4 kB alias. Successive
+// buffers are therefore shifted by a different multiple of ALLOC_COLOUR, which made the y- and z-solves of a 256x257x256
+// grid about a third faster than with all buffers at the same offset. Power of two strides between the rows of a system
+// still map a whole system to one cache set, so the rows should be padded.
+//
+tridStatus_t tridMalloc(void **ptr, size_t size) {
+  if(ptr == NULL) return TRID_STATUS_INVALID_VALUE;
+  *ptr = NULL;
+
+  size_t bytes  = ALLOC_ALIGN + ROUND_UP(size, ALLOC_ALIGN); // Header and whole SIMD vectors
+  size_t offset = ALLOC_ALIGN;                               // Start of the buffer in the allocation
+  char  *base   = NULL;
+  size_t len    = 0;
+  int    mapped = 0;
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+  int mode = huge_page_mode();
+  if(mode > 0 && bytes >= HUGE_PAGE_BYTES) {
+    static int colour = 0;
+    int c;
+    #pragma omp atomic capture
+    c = colour++;
+    offset = ALLOC_ALIGN + (c % ALLOC_COLOURS)*ALLOC_COLOUR;
+    len    = ROUND_UP(bytes - ALLOC_ALIGN + offset, HUGE_PAGE_BYTES);
+#ifdef MAP_HUGETLB
+    if(mode == 2) {
+      void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if(p != MAP_FAILED) base = (char*)p;
+    }
+#endif
+    if(base == NULL) {
+      // Map one more huge page and trim the mapping to a huge page boundary, so the kernel can back all of it
+      void *p = mmap(NULL, len + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if(p != MAP_FAILED) {
+        char  *aligned = (char*)ROUND_UP((uintptr_t)p, (uintptr_t)HUGE_PAGE_BYTES);
+        size_t head    = aligned - (char*)p;
+        if(head > 0) munmap(p, head);
+        munmap(aligned + len, HUGE_PAGE_BYTES - head);
+        base = aligned;
+#ifdef MADV_HUGEPAGE
+        madvise(base, len, MADV_HUGEPAGE);
+#endif
+      }
+    }
+    mapped = (base != NULL);
+  }
+#endif
+  if(base == NULL) {
+    offset = ALLOC_ALIGN;
+    len    = bytes;
+    if(posix_memalign((void**)&base, ALLOC_ALIGN, len) != 0) return TRID_STATUS_ALLOC_FAILED;
+  }
+  trid_alloc_header *h = (trid_alloc_header*)(base + offset - ALLOC_ALIGN);
+  h->base   = base;
+  h->len    = len;
+  h->mapped = mapped;
+  *ptr = base + offset;
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridFree(void *ptr) {
+  if(ptr == NULL) return TRID_STATUS_SUCCESS;
+  trid_alloc_header *h = (trid_alloc_header*)((char*)ptr - ALLOC_ALIGN);
+#if defined(__linux__) && defined(MAP_ANONYMOUS)
+  if(h->mapped) {
+    munmap(h->base, h->len);
+    return TRID_STATUS_SUCCESS;
+  }
+#endif
+  free(h->base);
+  return TRID_STATUS_SUCCESS;
+}
@@ -0,0 +1,472 @@
+/*
+ * Open source copyright declaration based on BSD open source template:
+ * http://www.opensource.org/licenses/bsd-license.php
+ *
+ * This file is part of the scalar-tridiagonal solver distribution.
+ *
+ * Copyright (c) 2015, Endre László and others. Please see the AUTHORS file in
+ * the main source directory for a full list of copyright holders.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * The name of Endre László may not be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Endre László ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Endre László BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Runtime selection of the vector ISA used by the CPU library. trid_cpu.cpp is compiled once for every ISA listed in
+// TRID_CPU_ISAS (see CMakeLists.txt) and the widest one supported by the CPU is picked at the first call. The choice
+// can be overridden with the TRID_CPU_ISA environment variable, eg. TRID_CPU_ISA=avx for benchmarking.
+//
+// This file has to be compiled for the baseline architecture, as it runs before any ISA check is made.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include "trid_cpu.h"
+#include "trid_cpu_dispatch.hpp"
+
+#if defined(__MIC__) || !(defined(__GNUC__) || defined(__INTEL_COMPILER))
+  #define CPU_SUPPORTS(feature) 1 // Native builds support only the ISA they are compiled for
+#else
+  #define CPU_SUPPORTS(feature) __builtin_cpu_supports(feature)
+#endif
+
+static int has_sse42()  { return CPU_SUPPORTS("sse4.2"); }
+static int has_avx()    { return CPU_SUPPORTS("avx"); }
+static int has_avx2()   { return CPU_SUPPORTS("avx2") && CPU_SUPPORTS("fma"); }
+static int has_avx512() { return CPU_SUPPORTS("avx512f"); }
+#ifdef TRID_HAVE_KNC
+static int has_knc()    { return 1; }
+#endif
+
+struct trid_isa {
+  const char             *name;
+  int                    (*supported)();
+  const trid_cpu_kernels *kernels;
+};
+
+// Ordered from the widest ISA to the narrowest, named as in the TRID_CPU_ISAS CMake variable
+static const trid_isa isas[] = {
+#ifdef TRID_HAVE_AVX512
+  {"avx512", has_avx512, &trid_avx512::kernels},
+#endif
+#ifdef TRID_HAVE_AVX2
+  {"avx2",   has_avx2,   &trid_avx2::kernels},
+#endif
+#ifdef TRID_HAVE_AVX
+  {"avx",    has_avx,    &trid_avx::kernels},
+#endif
+#ifdef TRID_HAVE_SSE42
+  {"sse42",  has_sse42,  &trid_sse42::kernels},
+#endif
+#ifdef TRID_HAVE_KNC
+  {"knc",    has_knc,    &trid_knc::kernels},
+#endif
+  {NULL, NULL, NULL}
+};
+
+static const trid_isa* select_isa() {
+#if !defined(__MIC__) && (defined(__GNUC__) || defined(__INTEL_COMPILER))
+  __builtin_cpu_init();
+#endif
+  const char *env = getenv("TRID_CPU_ISA");
+  if(env != NULL && env[0] != '\0') {
+    for(const trid_isa *it = isas; it->name != NULL; it++) {
+      if(strcmp(env, it->name) == 0) {
+        if(it->supported()) return it;
+        break;
+      }
+    }
+    fprintf(stderr, "libtrid: TRID_CPU_ISA=%s is not available on this CPU or in this build, using the default\n", env);
+  }
+  for(const trid_isa *it = isas; it->name != NULL; it++) {
+    if(it->supported()) return it;
+  }
+  fprintf(stderr, "libtrid: none of the vector ISAs the library was built for is supported by this CPU\n");
+  abort();
+}
+
+// Thread safe initialization at the first call
+static const trid_isa* selected_isa() {
+  static const trid_isa *selected = select_isa();
+  return selected;
+}
+
+//
+// Arrays may be aligned only for a narrower ISA than the selected one, eg. allocated with 32 byte alignment on an
+// AVX-512 machine. Such calls are solved with the widest ISA the arrays are aligned for instead of the scalar fallback.
+//
+template<typename REAL>
+static const trid_cpu_kernels* aligned_kernels(const REAL *a, const REAL *b, const REAL *c, const REAL *d, const REAL *u, int ndim, const int *pads) {
+  const trid_isa *selected = selected_isa();
+  if(ndim < 1 || pads == NULL) return selected->kernels; // Invalid arguments are reported by the solver
+  for(const trid_isa *it = selected; it->name != NULL; it++) {
+    long width     = it->kernels->width;
+    long isaligned = (long)a % width + (long)b % width + (long)c % width + (long)d % width + pads[0] % (width/sizeof(REAL));
+    if(u != NULL) isaligned += (long)u % width;
+    if(isaligned == 0 && it->supported()) return it->kernels;
+  }
+  return selected->kernels;
+}
+
+const char* tridGetCpuIsa() {
+  return selected_isa()->name;
+}
+
+tridStatus_t tridSmtsvStridedBatch(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(a, b, c, d, NULL, ndim, pads)->mtsvS(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(a, b, c, d, u, ndim, pads)->mtsvSInc(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchNrhs(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return aligned_kernels<float>(a, b, c, d, NULL, ndim, pads)->mtsvNrhsS(a, b, c, d, u, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridSmtsvStridedBatchNrhsInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return aligned_kernels<float>(a, b, c, d, u, ndim, pads)->mtsvNrhsSInc(a, b, c, d, u, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridSmtsvStridedBatchCyclic(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(a, b, c, d, NULL, ndim, pads)->mtsvCyclicS(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCyclicInc(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(a, b, c, d, u, ndim, pads)->mtsvCyclicSInc(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+void trid_scalarS(float* a, float* b, float* c, float* d, float* u, int N, int stride) {
+  selected_isa()->kernels->scalarS(a, b, c, d, u, N, stride);
+}
+
+void trid_x_transposeS(float* a, float* b, float* c, float* d, float* u, int sys_size, int sys_pad, int stride) {
+  selected_isa()->kernels->x_transposeS(a, b, c, d, u, sys_size, sys_pad, stride);
+}
+
+void trid_scalar_vecS(float* a, float* b, float* c, float* d, float* u, int N, int stride) {
+  selected_isa()->kernels->scalar_vecS(a, b, c, d, u, N, stride);
+}
+
+void trid_scalar_vecSInc(float* a, float* b, float* c, float* d, float* u, int N, int stride) {
+  selected_isa()->kernels->scalar_vecSInc(a, b, c, d, u, N, stride);
+}
+
+tridStatus_t tridDmtsvStridedBatch(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(a, b, c, d, NULL, ndim, pads)->mtsvD(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(a, b, c, d, u, ndim, pads)->mtsvDInc(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchNrhs(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return aligned_kernels<double>(a, b, c, d, NULL, ndim, pads)->mtsvNrhsD(a, b, c, d, u, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridDmtsvStridedBatchNrhsInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrhs) {
+  return aligned_kernels<double>(a, b, c, d, u, ndim, pads)->mtsvNrhsDInc(a, b, c, d, u, ndim, solvedim, dims, pads, nrhs);
+}
+
+tridStatus_t tridDmtsvStridedBatchCyclic(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(a, b, c, d, NULL, ndim, pads)->mtsvCyclicD(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchCyclicInc(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(a, b, c, d, u, ndim, pads)->mtsvCyclicDInc(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+// The float coefficients have to be aligned for float vectors, d and u for double vectors
+tridStatus_t tridDmtsvStridedBatchMixed(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine) {
+  return aligned_kernels<float>(a, b, c, (float*)d, NULL, ndim, pads)->mtsvMixedD(a, b, c, d, u, ndim, solvedim, dims, pads, nrefine);
+}
+
+tridStatus_t tridDmtsvStridedBatchMixedInc(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine) {
+  return aligned_kernels<float>(a, b, c, (float*)d, (float*)u, ndim, pads)->mtsvMixedDInc(a, b, c, d, u, ndim, solvedim, dims, pads, nrefine);
+}
+
+// Reduced precision coefficients are loaded unaligned, only d and u select the ISA
+tridStatus_t tridSmtsvStridedBatchCoefF16(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(d, d, d, d, NULL, ndim, pads)->mtsvCoefF16S(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCoefF16Inc(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(d, d, d, d, u, ndim, pads)->mtsvCoefF16SInc(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCoefBF16(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(d, d, d, d, NULL, ndim, pads)->mtsvCoefBF16S(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchCoefBF16Inc(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(d, d, d, d, u, ndim, pads)->mtsvCoefBF16SInc(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchCoefF32(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(d, d, d, d, NULL, ndim, pads)->mtsvCoefF32D(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchCoefF32Inc(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(d, d, d, d, u, ndim, pads)->mtsvCoefF32DInc(a, b, c, d, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchPacked(float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(abcd, abcd, abcd, abcd, NULL, ndim, pads)->mtsvPackedS(abcd, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvStridedBatchPackedInc(const float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<float>(abcd, abcd, abcd, abcd, u, ndim, pads)->mtsvPackedSInc(abcd, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchPacked(double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(abcd, abcd, abcd, abcd, NULL, ndim, pads)->mtsvPackedD(abcd, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvStridedBatchPackedInc(const double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads) {
+  return aligned_kernels<double>(abcd, abcd, abcd, abcd, u, ndim, pads)->mtsvPackedDInc(abcd, u, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSgtsvInterleavedBatch(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int nsys_pad) {
+  return aligned_kernels<float>(a, b, c, d, NULL, 1, &nsys_pad)->gtsvInterleavedS(a, b, c, d, u, N, nsys, nsys_pad);
+}
+
+tridStatus_t tridSgtsvInterleavedBatchInc(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int nsys_pad) {
+  return aligned_kernels<float>(a, b, c, d, u, 1, &nsys_pad)->gtsvInterleavedSInc(a, b, c, d, u, N, nsys, nsys_pad);
+}
+
+// With SIMD_VEC a power of two, sys_pad|nsys_pad is a multiple of it only if both paddings are
+tridStatus_t tridSconvertToInterleaved(const float *src, float *dst, int N, int nsys, int sys_pad, int nsys_pad) {
+  int pads = sys_pad | nsys_pad;
+  return aligned_kernels<float>(src, src, dst, dst, NULL, 1, &pads)->toInterleavedS(src, dst, N, nsys, sys_pad, nsys_pad);
+}
+
+tridStatus_t tridSconvertFromInterleaved(const float *src, float *dst, int N, int nsys, int nsys_pad, int sys_pad) {
+  int pads = sys_pad | nsys_pad;
+  return aligned_kernels<float>(src, src, dst, dst, NULL, 1, &pads)->fromInterleavedS(src, dst, N, nsys, nsys_pad, sys_pad);
+}
+
+tridStatus_t tridDgtsvInterleavedBatch(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int nsys_pad) {
+  return aligned_kernels<double>(a, b, c, d, NULL, 1, &nsys_pad)->gtsvInterleavedD(a, b, c, d, u, N, nsys, nsys_pad);
+}
+
+tridStatus_t tridDgtsvInterleavedBatchInc(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int nsys_pad) {
+  return aligned_kernels<double>(a, b, c, d, u, 1, &nsys_pad)->gtsvInterleavedDInc(a, b, c, d, u, N, nsys, nsys_pad);
+}
+
+//
+// The ragged kernels load unaligned rows and need no alignment. They take the systems longest first; the order is
+// sorted here rather than in trid_cpu.cpp, whose ISA builds would each instantiate the std:: templates.
+//
+struct ragged_longer {
+  const int *lengths;
+  bool operator()(int s, int t) const { return lengths[s] > lengths[t]; }
+};
+
+template<typename REAL, typename F>
+static tridStatus_t ragged_solve(F solve, const REAL *a, const REAL *b, const REAL *c, REAL *d, REAL *u, const long *offsets, const int *lengths, int nsys) {
+  if(nsys < 0 || (nsys > 0 && (offsets == NULL || lengths == NULL))) return TRID_STATUS_INVALID_VALUE;
+  for(int s=0; s<nsys; s++)
+    if(lengths[s] < 1 || offsets[s] < 0) return TRID_STATUS_INVALID_VALUE;
+  if(nsys == 0) return TRID_STATUS_SUCCESS;
+
+  std::vector<int> order(nsys);
+  for(int s=0; s<nsys; s++) order[s] = s;
+  ragged_longer longer = { lengths };
+  std::stable_sort(order.begin(), order.end(), longer);
+  return solve(a, b, c, d, u, offsets, lengths, &order[0], nsys);
+}
+
+tridStatus_t tridSgtsvRaggedBatch(const float *a, const float *b, const float *c, float *d, float *u, const long *offsets, const int *lengths, int nsys) {
+  return ragged_solve<float>(selected_isa()->kernels->gtsvRaggedS, a, b, c, d, u, offsets, lengths, nsys);
+}
+
+tridStatus_t tridSgtsvRaggedBatchInc(const float *a, const float *b, const float *c, float *d, float *u, const long *offsets, const int *lengths, int nsys) {
+  return ragged_solve<float>(selected_isa()->kernels->gtsvRaggedSInc, a, b, c, d, u, offsets, lengths, nsys);
+}
+
+tridStatus_t tridDgtsvRaggedBatch(const double *a, const double *b, const double *c, double *d, double *u, const long *offsets, const int *lengths, int nsys) {
+  return ragged_solve<double>(selected_isa()->kernels->gtsvRaggedD, a, b, c, d, u, offsets, lengths, nsys);
+}
+
+tridStatus_t tridDgtsvRaggedBatchInc(const double *a, const double *b, const double *c, double *d, double *u, const long *offsets, const int *lengths, int nsys) {
+  return ragged_solve<double>(selected_isa()->kernels->gtsvRaggedDInc, a, b, c, d, u, offsets, lengths, nsys);
+}
+
+// With SIMD_VEC a power of two, sys_pad|nsys_pad is a multiple of it only if both paddings are
+tridStatus_t tridDconvertToInterleaved(const double *src, double *dst, int N, int nsys, int sys_pad, int nsys_pad) {
+  int pads = sys_pad | nsys_pad;
+  return aligned_kernels<double>(src, src, dst, dst, NULL, 1, &pads)->toInterleavedD(src, dst, N, nsys, sys_pad, nsys_pad);
+}
+
+tridStatus_t tridDconvertFromInterleaved(const double *src, double *dst, int N, int nsys, int nsys_pad, int sys_pad) {
+  int pads = sys_pad | nsys_pad;
+  return aligned_kernels<double>(src, src, dst, dst, NULL, 1, &pads)->fromInterleavedD(src, dst, N, nsys, nsys_pad, sys_pad);
+}
+
+void trid_scalarD(double* a, double* b, double* c, double* d, double* u, int N, int stride) {
+  selected_isa()->kernels->scalarD(a, b, c, d, u, N, stride);
+}
+
+void trid_x_transposeD(double* a, double* b, double* c, double* d, double* u, int sys_size, int sys_pad, int stride) {
+  selected_isa()->kernels->x_transposeD(a, b, c, d, u, sys_size, sys_pad, stride);
+}
+
+void trid_scalar_vecD(double* a, double* b, double* c, double* d, double* u, int N, int stride) {
+  selected_isa()->kernels->scalar_vecD(a, b, c, d, u, N, stride);
+}
+
+void trid_scalar_vecDInc(double* a, double* b, double* c, double* d, double* u, int N, int stride) {
+  selected_isa()->kernels->scalar_vecDInc(a, b, c, d, u, N, stride);
+}
+
+//
+// Plans are created with the kernels of the selected ISA. Arrays that are not aligned for them are solved without the
+// plan by the widest ISA they are aligned for.
+//
+tridStatus_t tridSmtsvPlanCreate(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads) {
+  return selected_isa()->kernels->planCreateS(plan, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridSmtsvPlanExecute(tridPlan_t plan, const float *a, const float *b, const float *c, float *d, float* u) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(float)) return TRID_STATUS_INVALID_VALUE;
+  const trid_cpu_kernels *k = aligned_kernels<float>(a, b, c, d, NULL, plan->ndim, plan->pads);
+  if(k != plan->kernels) return k->mtsvS(a, b, c, d, u, plan->ndim, plan->solvedim, plan->dims, plan->pads);
+  return k->planExecS(plan, a, b, c, d, u);
+}
+
+tridStatus_t tridSmtsvPlanExecuteInc(tridPlan_t plan, const float *a, const float *b, const float *c, float *d, float* u) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(float)) return TRID_STATUS_INVALID_VALUE;
+  const trid_cpu_kernels *k = aligned_kernels<float>(a, b, c, d, u, plan->ndim, plan->pads);
+  if(k != plan->kernels) return k->mtsvSInc(a, b, c, d, u, plan->ndim, plan->solvedim, plan->dims, plan->pads);
+  return k->planExecSInc(plan, a, b, c, d, u);
+}
+
+tridStatus_t tridDmtsvPlanCreate(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads) {
+  return selected_isa()->kernels->planCreateD(plan, ndim, solvedim, dims, pads);
+}
+
+tridStatus_t tridDmtsvPlanExecute(tridPlan_t plan, const double *a, const double *b, const double *c, double *d, double* u) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(double)) return TRID_STATUS_INVALID_VALUE;
+  const trid_cpu_kernels *k = aligned_kernels<double>(a, b, c, d, NULL, plan->ndim, plan->pads);
+  if(k != plan->kernels) return k->mtsvD(a, b, c, d, u, plan->ndim, plan->solvedim, plan->dims, plan->pads);
+  return k->planExecD(plan, a, b, c, d, u);
+}
+
+tridStatus_t tridDmtsvPlanExecuteInc(tridPlan_t plan, const double *a, const double *b, const double *c, double *d, double* u) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(double)) return TRID_STATUS_INVALID_VALUE;
+  const trid_cpu_kernels *k = aligned_kernels<double>(a, b, c, d, u, plan->ndim, plan->pads);
+  if(k != plan->kernels) return k->mtsvDInc(a, b, c, d, u, plan->ndim, plan->solvedim, plan->dims, plan->pads);
+  return k->planExecDInc(plan, a, b, c, d, u);
+}
+
+//
+// Factors are computed and used by the ISA the plan was created for. Arrays that are not aligned for it are solved by
+// the scalar kernels of the same ISA.
+//
+tridStatus_t tridSmtsvPlanFactorize(tridPlan_t plan, const float *a, const float *b, const float *c) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(float)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planFactorS(plan, a, b, c);
+}
+
+tridStatus_t tridSmtsvPlanFactorizeToeplitz(tridPlan_t plan, float a, float b, float c, float b0, float c0, float an, float bn) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(float)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planToeplitzS(plan, a, b, c, b0, c0, an, bn);
+}
+
+tridStatus_t tridSmtsvPlanSolve(tridPlan_t plan, float *d, float *u) {
+  if(plan == NULL || plan->factors == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(float)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planSolveS(plan, d, u);
+}
+
+tridStatus_t tridSmtsvPlanSolveInc(tridPlan_t plan, float *d, float *u) {
+  if(plan == NULL || plan->factors == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(float)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planSolveSInc(plan, d, u);
+}
+
+tridStatus_t tridDmtsvPlanFactorize(tridPlan_t plan, const double *a, const double *b, const double *c) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(double)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planFactorD(plan, a, b, c);
+}
+
+tridStatus_t tridDmtsvPlanFactorizeToeplitz(tridPlan_t plan, double a, double b, double c, double b0, double c0, double an, double bn) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(double)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planToeplitzD(plan, a, b, c, b0, c0, an, bn);
+}
+
+tridStatus_t tridDmtsvPlanSolve(tridPlan_t plan, double *d, double *u) {
+  if(plan == NULL || plan->factors == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(double)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planSolveD(plan, d, u);
+}
+
+tridStatus_t tridDmtsvPlanSolveInc(tridPlan_t plan, double *d, double *u) {
+  if(plan == NULL || plan->factors == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(plan->real_size != sizeof(double)) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planSolveDInc(plan, d, u);
+}
+
+tridStatus_t tridPlanSetStream(tridPlan_t plan, int mode) {
+  if(plan == NULL || mode < 0 || mode > 2) return TRID_STATUS_INVALID_VALUE;
+  plan->stream = mode;
+  return TRID_STATUS_SUCCESS;
+}
+
+//
+// The partition and the placement are those of the ISA the plan was created for, i.e. of aligned arrays. Hybrid plans
+// split every system between the threads, so they have no partition of systems to return or to count elements of.
+//
+tridStatus_t tridPlanGetPartition(tridPlan_t plan, int thread, long *offsets, long *nsys) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(thread < 0 || thread >= plan->nthreads || nsys == NULL) return TRID_STATUS_INVALID_VALUE;
+  if(plan->hybrid_chunks > 0) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planPartition(plan, thread, offsets, nsys);
+}
+
+tridStatus_t tridPlanFirstTouch(tridPlan_t plan, void *array, int policy) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(array == NULL || policy < 0 || policy > 1) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planTouch(plan, array, policy);
+}
+
+tridStatus_t tridPlanGetLocality(tridPlan_t plan, const void *array, int nnodes, long *local, long *remote) {
+  if(plan == NULL) return TRID_STATUS_NOT_INITIALIZED;
+  if(array == NULL || nnodes < 1 || local == NULL || remote == NULL) return TRID_STATUS_INVALID_VALUE;
+  if(plan->hybrid_chunks > 0) return TRID_STATUS_INVALID_VALUE;
+  return plan->kernels->planLocality(plan, array, nnodes, local, remote);
+}
+
+tridStatus_t tridPlanDestroy(tridPlan_t plan) {
+  if(plan == NULL) return TRID_STATUS_SUCCESS;
+  return plan->kernels->planDestroy(plan);
+}
@@ -0,0 +1,187 @@
+/*
+ * Open source copyright declaration based on BSD open source template:
+ * http://www.opensource.org/licenses/bsd-license.php
+ *
+ * This file is part of the scalar-tridiagonal solver distribution.
+ *
+ * Copyright (c) 2015, Endre László and others. Please see the AUTHORS file in
+ * the main source directory for a full list of copyright holders.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * The name of Endre László may not be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Endre László ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Endre László BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __TRID_CPU_DISPATCH_HPP
+#define __TRID_CPU_DISPATCH_HPP
+
+#include "trid_common.h"
+#include "trid_cpu.h"
+
+//
+// Table of the library entry points compiled for one vector ISA. trid_cpu.cpp defines one table per ISA namespace
+// and trid_cpu_dispatch.cpp selects the one matching the CPU at the first call.
+//
+typedef tridStatus_t (*trid_mtsvS_t)(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_mtsvD_t)(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
+typedef void (*trid_scalarS_t)(float* a, float* b, float* c, float* d, float* u, int N, int stride);
+typedef void (*trid_scalarD_t)(double* a, double* b, double* c, double* d, double* u, int N, int stride);
+typedef void (*trid_x_transposeS_t)(float* a, float* b, float* c, float* d, float* u, int sys_size, int sys_pad, int stride);
+typedef void (*trid_x_transposeD_t)(double* a, double* b, double* c, double* d, double* u, int sys_size, int sys_pad, int stride);
+typedef tridStatus_t (*trid_planCreate_t)(tridPlan_t *plan, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_planExecS_t)(tridPlan_t plan, const float *a, const float *b, const float *c, float *d, float *u);
+typedef tridStatus_t (*trid_planExecD_t)(tridPlan_t plan, const double *a, const double *b, const double *c, double *d, double *u);
+typedef tridStatus_t (*trid_planDestroy_t)(tridPlan_t plan);
+typedef tridStatus_t (*trid_planPartition_t)(tridPlan_t plan, int thread, long *offsets, long *nsys);
+typedef tridStatus_t (*trid_planTouch_t)(tridPlan_t plan, void *array, int policy);
+typedef tridStatus_t (*trid_planLocality_t)(tridPlan_t plan, const void *array, int nnodes, long *local, long *remote);
+typedef tridStatus_t (*trid_planFactorS_t)(tridPlan_t plan, const float *a, const float *b, const float *c);
+typedef tridStatus_t (*trid_planFactorD_t)(tridPlan_t plan, const double *a, const double *b, const double *c);
+typedef tridStatus_t (*trid_planSolveS_t)(tridPlan_t plan, float *d, float *u);
+typedef tridStatus_t (*trid_planSolveD_t)(tridPlan_t plan, double *d, double *u);
+typedef tridStatus_t (*trid_planToeplitzS_t)(tridPlan_t plan, float a, float b, float c, float b0, float c0, float an, float bn);
+typedef tridStatus_t (*trid_planToeplitzD_t)(tridPlan_t plan, double a, double b, double c, double b0, double c0, double an, double bn);
+typedef tridStatus_t (*trid_mtsvNrhsS_t)(const float *a, const float *b, const float *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads, int nrhs);
+typedef tridStatus_t (*trid_mtsvNrhsD_t)(const double *a, const double *b, const double *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrhs);
+typedef tridStatus_t (*trid_mtsvMixedD_t)(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads, int nrefine);
+typedef tridStatus_t (*trid_mtsvCoef16S_t)(const unsigned short *a, const unsigned short *b, const unsigned short *c, float *d, float* u, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_mtsvCoef32D_t)(const float *a, const float *b, const float *c, double *d, double* u, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_gtsvInterleavedS_t)(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int nsys_pad);
+typedef tridStatus_t (*trid_gtsvInterleavedD_t)(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int nsys_pad);
+typedef tridStatus_t (*trid_convertS_t)(const float *src, float *dst, int N, int nsys, int src_pad, int dst_pad);
+typedef tridStatus_t (*trid_convertD_t)(const double *src, double *dst, int N, int nsys, int src_pad, int dst_pad);
+typedef tridStatus_t (*trid_mtsvPackedS_t)(float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_mtsvPackedSInc_t)(const float *abcd, float *u, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_mtsvPackedD_t)(double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_mtsvPackedDInc_t)(const double *abcd, double *u, int ndim, int solvedim, int *dims, int *pads);
+typedef tridStatus_t (*trid_gtsvRaggedS_t)(const float *a, const float *b, const float *c, float *d, float *u, const long *offsets, const int *lengths, const int *order, int nsys);
+typedef tridStatus_t (*trid_gtsvRaggedD_t)(const double *a, const double *b, const double *c, double *d, double *u, const long *offsets, const int *lengths, const int *order, int nsys);
+
+struct trid_cpu_kernels {
+  int                 width; // Width of the SIMD vector unit in bytes, ie. the alignment the vector kernels need
+  trid_mtsvS_t        mtsvS;
+  trid_mtsvS_t        mtsvSInc;
+  trid_scalarS_t      scalarS;
+  trid_x_transposeS_t x_transposeS;
+  trid_scalarS_t      scalar_vecS;
+  trid_scalarS_t      scalar_vecSInc;
+  trid_mtsvD_t        mtsvD;
+  trid_mtsvD_t        mtsvDInc;
+  trid_scalarD_t      scalarD;
+  trid_x_transposeD_t x_transposeD;
+  trid_scalarD_t      scalar_vecD;
+  trid_scalarD_t      scalar_vecDInc;
+  trid_planCreate_t   planCreateS;
+  trid_planExecS_t    planExecS;
+  trid_planExecS_t    planExecSInc;
+  trid_planCreate_t   planCreateD;
+  trid_planExecD_t    planExecD;
+  trid_planExecD_t    planExecDInc;
+  trid_planDestroy_t  planDestroy;
+  trid_planPartition_t planPartition;
+  trid_planTouch_t    planTouch;
+  trid_planLocality_t planLocality;
+  trid_planFactorS_t  planFactorS;
+  trid_planSolveS_t   planSolveS;
+  trid_planSolveS_t   planSolveSInc;
+  trid_planFactorD_t  planFactorD;
+  trid_planSolveD_t   planSolveD;
+  trid_planSolveD_t   planSolveDInc;
+  trid_planToeplitzS_t planToeplitzS;
+  trid_planToeplitzD_t planToeplitzD;
+  trid_mtsvNrhsS_t    mtsvNrhsS;
+  trid_mtsvNrhsS_t    mtsvNrhsSInc;
+  trid_mtsvNrhsD_t    mtsvNrhsD;
+  trid_mtsvNrhsD_t    mtsvNrhsDInc;
+  trid_mtsvS_t        mtsvCyclicS;
+  trid_mtsvS_t        mtsvCyclicSInc;
+  trid_mtsvD_t        mtsvCyclicD;
+  trid_mtsvD_t        mtsvCyclicDInc;
+  trid_mtsvMixedD_t   mtsvMixedD;
+  trid_mtsvMixedD_t   mtsvMixedDInc;
+  trid_mtsvCoef16S_t  mtsvCoefF16S;
+  trid_mtsvCoef16S_t  mtsvCoefF16SInc;
+  trid_mtsvCoef16S_t  mtsvCoefBF16S;
+  trid_mtsvCoef16S_t  mtsvCoefBF16SInc;
+  trid_mtsvCoef32D_t  mtsvCoefF32D;
+  trid_mtsvCoef32D_t  mtsvCoefF32DInc;
+  trid_gtsvInterleavedS_t gtsvInterleavedS;
+  trid_gtsvInterleavedS_t gtsvInterleavedSInc;
+  trid_gtsvInterleavedD_t gtsvInterleavedD;
+  trid_gtsvInterleavedD_t gtsvInterleavedDInc;
+  trid_convertS_t     toInterleavedS;
+  trid_convertS_t     fromInterleavedS;
+  trid_convertD_t     toInterleavedD;
+  trid_convertD_t     fromInterleavedD;
+  trid_mtsvPackedS_t  mtsvPackedS;
+  trid_mtsvPackedSInc_t mtsvPackedSInc;
+  trid_mtsvPackedD_t  mtsvPackedD;
+  trid_mtsvPackedDInc_t mtsvPackedDInc;
+  trid_gtsvRaggedS_t  gtsvRaggedS;
+  trid_gtsvRaggedS_t  gtsvRaggedSInc;
+  trid_gtsvRaggedD_t  gtsvRaggedD;
+  trid_gtsvRaggedD_t  gtsvRaggedDInc;
+};
+
+//
+// Solver plan: geometry of a batch, the offsets of its system rows and the workspace of the forward pass, kept
+// between executions. Created by the kernels of one ISA and executed by the same ones.
+//
+struct tridPlan_st {
+  const trid_cpu_kernels *kernels;   // Kernels of the ISA the plan was created for
+  int   real_size;                   // sizeof(float) or sizeof(double)
+  int   ndim;
+  int   solvedim;
+  int   dims[MAXDIM];
+  int   pads[MAXDIM];
+  long  cumpads[MAXDIM+1];           // Cummulative-multiplication of paddings
+  int   sys_size;                    // Size (length) of a system
+  long  sys_stride;                  // Stride between the consecutive elements of a system
+  int   lanedim;                     // Dimension mapped onto the SIMD lanes, -1 for a single system
+  int   lane_n;                      // Number of systems along the SIMD lanes
+  long  lane_stride;                 // Stride between systems along the SIMD lanes
+  int   lane_vec;                    // Systems solved in SIMD vectors when the arrays are aligned
+  long  out_n;                       // Number of system rows in the other dimensions
+  long *outer;                       // Offsets of the system rows, NULL if computed on the fly
+  int   nthreads;                    // Number of threads the workspace is allocated for
+  long  ws_len;                      // Length of the workspace of one thread in elements
+  void *ws;                          // Workspace of the forward pass
+  int   hybrid_chunks;               // Chunks per system of the hybrid Thomas-PCR solver, 0 for Thomas per system
+  long  hws_len;                     // Length of the hybrid solver workspace of one system in elements
+  void *hws;                         // Workspace of the hybrid solver, NULL if not used
+  int   x_gather;                    // x-systems gathered by trid_x_gather(): 0 never, 1 if not transposable, 2 always
+  int   x_compact;                   // x-systems solved by trid_x_transpose_compact() rather than trid_x_transpose()
+  int   lane_mask;                   // Systems past the aligned vectors solved in vectors with masked lanes
+  int   stream;                      // Non-temporal stores of the solution: 0 never, 1 for long systems, 2 always
+  long  cache_bytes;                 // Size of the L2 cache for stream == 1
+  long  fact_len;                    // Length of one factor array in elements
+  int   fact_vec;                    // x-systems whose factors are interleaved in groups of SIMD_VEC
+  int   fact_toeplitz;               // Factors are a single sequence shared by every system
+  void *factors;                     // 1/b', a/b' and c' of trid?mtsvPlanFactorize*(), NULL if not factorized
+};
+
+namespace trid_sse42  { extern const trid_cpu_kernels kernels; }
+namespace trid_avx    { extern const trid_cpu_kernels kernels; }
+namespace trid_avx2   { extern const trid_cpu_kernels kernels; }
+namespace trid_avx512 { extern const trid_cpu_kernels kernels; }
+namespace trid_knc    { extern const trid_cpu_kernels kernels; }
+
+#endif
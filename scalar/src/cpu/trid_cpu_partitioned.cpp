@@ -0,0 +1,134 @@
+/*
+ * Open source copyright declaration based on BSD open source template:
+ * http://www.opensource.org/licenses/bsd-license.php
+ *
+ * This file is part of the scalar-tridiagonal solver distribution.
+ *
+ * Copyright (c) 2015, Endre László and others. Please see the AUTHORS file in
+ * the main source directory for a full list of copyright holders.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * The name of Endre László may not be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Endre László ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Endre László BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Partitioned solver for a few very long systems. Every system is split into chunks that are reduced independently by
+// the modified Thomas algorithm of trid_mpi_cpu.hpp to two boundary rows each. The reduced systems are solved with
+// Thomas, then every chunk substitutes its boundary unknowns into its interior.
+//
+// The solver doesn't depend on the vector ISA, so this file is compiled for the baseline architecture.
+//
+#include <stdlib.h>
+#include <omp.h>
+#include <xmmintrin.h>
+#include "trid_cpu.h"
+#include "trid_mpi_cpu.hpp"
+
+#define PART_MIN_ROWS 64 // Shortest chunk a system is split into
+
+// x-solve of nsys systems as a batch, for systems too short to split
+template<int INC> inline tridStatus_t batch_solve(const float *a, const float *b, const float *c, float *d, float *u, int *dims, int *pads) {
+  return INC ? tridSmtsvStridedBatchInc(a, b, c, d, u, 2, 0, dims, pads) : tridSmtsvStridedBatch(a, b, c, d, u, 2, 0, dims, pads);
+}
+
+template<int INC> inline tridStatus_t batch_solve(const double *a, const double *b, const double *c, double *d, double *u, int *dims, int *pads) {
+  return INC ? tridDmtsvStridedBatchInc(a, b, c, d, u, 2, 0, dims, pads) : tridDmtsvStridedBatch(a, b, c, d, u, 2, 0, dims, pads);
+}
+
+template<typename REAL, int INC>
+tridStatus_t tridPartitionedSolve(const REAL *a, const REAL *b, const REAL *c, REAL *d, REAL *u, int N, int nsys, int sys_pad) {
+  if(N < 1 || nsys < 1 || sys_pad < N) return TRID_STATUS_INVALID_VALUE;
+
+  // Enough chunks to give every thread one
+  int nthreads = omp_get_max_threads();
+  int P        = (nthreads + nsys-1) / nsys;
+  if(P > N/PART_MIN_ROWS) P = N/PART_MIN_ROWS;
+  if(P < 2) { // Too short to split: solve as a batch
+    int dims[2] = {N, nsys};
+    int pads[2] = {sys_pad, nsys};
+    return batch_solve<INC>(a, b, c, d, u, dims, pads);
+  }
+
+  // aa, cc and dd of every row, then the aa, cc and dd of the 2*P rows of every reduced system
+  long  len = (long)nsys*N;
+  REAL *ws  = (REAL*) _mm_malloc(sizeof(REAL)*(3*len + 6L*nsys*P), 64);
+  if(ws == NULL) return TRID_STATUS_ALLOC_FAILED;
+  REAL *aa = ws, *cc = &ws[len], *dd = &ws[2*len];
+  REAL *aa_r = &ws[3*len], *cc_r = &aa_r[2L*nsys*P], *dd_r = &cc_r[2L*nsys*P];
+
+  // The chunks are given to the threads in the same order in both passes, so each thread finds its data in its cache
+  #pragma omp parallel num_threads(nthreads)
+  {
+    #pragma omp for schedule(static)
+    for(long t=0; t<(long)nsys*P; t++) {
+      int  s   = t / P;
+      int  p   = t % P;
+      long beg = (long)p*N/P;
+      int  M   = (int)((long)(p+1)*N/P - beg);
+      long ind = (long)s*sys_pad + beg;
+      long w   = (long)s*N + beg;
+      thomas_forward<REAL>(&a[ind], &b[ind], &c[ind], &d[ind], NULL, &aa[w], &cc[w], &dd[w], M, 1);
+      aa_r[2*t]   = aa[w];
+      cc_r[2*t]   = cc[w];
+      dd_r[2*t]   = dd[w];
+      aa_r[2*t+1] = aa[w+M-1];
+      cc_r[2*t+1] = cc[w+M-1];
+      dd_r[2*t+1] = dd[w+M-1];
+    }
+    // The reduced systems are short, one thread solves each
+    #pragma omp for schedule(static)
+    for(int s=0; s<nsys; s++)
+      thomas_on_reduced<REAL>(&aa_r[2L*s*P], &cc_r[2L*s*P], &dd_r[2L*s*P], 2*P, 1);
+
+    #pragma omp for schedule(static)
+    for(long t=0; t<(long)nsys*P; t++) {
+      int  s   = t / P;
+      int  p   = t % P;
+      long beg = (long)p*N/P;
+      int  M   = (int)((long)(p+1)*N/P - beg);
+      long ind = (long)s*sys_pad + beg;
+      long w   = (long)s*N + beg;
+      dd[w]     = dd_r[2*t];
+      dd[w+M-1] = dd_r[2*t+1];
+      if(INC) thomas_backward_inc<REAL>(&aa[w], &cc[w], &dd[w], &u[ind], M, 1);
+      else    thomas_backward<REAL>    (&aa[w], &cc[w], &dd[w], &d[ind], M, 1);
+    }
+  }
+  _mm_free(ws);
+  return TRID_STATUS_SUCCESS;
+}
+
+tridStatus_t tridSgtsvPartitioned(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int sys_pad) {
+  return tridPartitionedSolve<float,0>(a, b, c, d, u, N, nsys, sys_pad);
+}
+
+tridStatus_t tridSgtsvPartitionedInc(const float *a, const float *b, const float *c, float *d, float *u, int N, int nsys, int sys_pad) {
+  return tridPartitionedSolve<float,1>(a, b, c, d, u, N, nsys, sys_pad);
+}
+
+tridStatus_t tridDgtsvPartitioned(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int sys_pad) {
+  return tridPartitionedSolve<double,0>(a, b, c, d, u, N, nsys, sys_pad);
+}
+
+tridStatus_t tridDgtsvPartitionedInc(const double *a, const double *b, const double *c, double *d, double *u, int N, int nsys, int sys_pad) {
+  return tridPartitionedSolve<double,1>(a, b, c, d, u, N, nsys, sys_pad);
+}
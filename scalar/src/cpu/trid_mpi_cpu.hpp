@@ -35,7 +35,7 @@
 #ifndef __TRID_MPI_CPU_HPP
 #define __TRID_MPI_CPU_HPP
 
-#include "trid_simd.h"
+#include <stdlib.h>
 #include "math.h"
 
 #define N_MPI_MAX 128
@@ -88,25 +88,24 @@
 
 
 //
-// Thomas solver for reduced system
+// Thomas solver for reduced system. The modified coefficients of the forward pass are stored in place of cc_r and
+// dd_r, so the length of the reduced system is not limited by a local buffer.
 //
 template<typename REAL>
 inline void thomas_on_reduced(
     const REAL* __restrict__ aa_r, 
-    const REAL* __restrict__ cc_r, 
+          REAL* __restrict__ cc_r, 
           REAL* __restrict__ dd_r, 
     int N, 
     int stride) {
   int   i, ind = 0;
-  FP aa, bb, cc, dd, c2[N_MAX], d2[N_MAX];
+  REAL aa, bb, cc, dd;
   //
   // forward pass
   //
   bb    = static_cast<REAL>(1.0);
   cc    = cc_r[0];
   dd    = dd_r[0];
-  c2[0] = cc;
-  d2[0] = dd;
 
   for(i=1; i<N; i++) {
     ind   = ind + stride;
@@ -116,16 +115,15 @@ inline void thomas_on_reduced(
     bb    = static_cast<REAL>(1.0)/bb;
     cc    = bb*cc_r[ind];
     dd    = bb*dd;
-    c2[i] = cc;
-    d2[i] = dd;
+    cc_r[ind] = cc;
+    dd_r[ind] = dd;
   }
   //
   // reverse pass
   //
-  dd_r[ind] = dd;
   for(i=N-2; i>=0; i--) {
     ind    = ind - stride;
-    dd     = d2[i] - c2[i]*dd;
+    dd     = dd_r[ind] - cc_r[ind]*dd;
     dd_r[ind] = dd;
   }
 }
@@ -204,4 +202,24 @@ inline void thomas_backward(
   }
   d[N-1] = dd[N-1];
 }
+
+//
+// Modified Thomas backward pass adding the solution to u
+//
+template<typename REAL>
+inline void thomas_backward_inc(
+    const REAL *__restrict__ aa, 
+    const REAL *__restrict__ cc, 
+    const REAL *__restrict__ dd, 
+          REAL *__restrict__ u, 
+    int N, 
+    int stride) {
+
+  u[0] += dd[0];
+  #pragma ivdep
+  for (int i=1; i<N-1; i++) {
+    u[i] += dd[i] - aa[i]*dd[0] - cc[i]*dd[N-1];
+  }
+  u[N-1] += dd[N-1];
+}
 #endif
@@ -0,0 +1,466 @@
+/*
+ * Open source copyright declaration based on BSD open source template:
+ * http://www.opensource.org/licenses/bsd-license.php
+ *
+ * This file is part of the scalar-tridiagonal solver distribution.
+ *
+ * Copyright (c) 2015, Endre László and others. Please see the AUTHORS file in
+ * the main source directory for a full list of copyright holders.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * The name of Endre László may not be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY Endre László ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Endre László BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __TRID_SIMD_TRAITS_HPP
+#define __TRID_SIMD_TRAITS_HPP
+
+//
+// Precision dependent SIMD types and operations of the CPU library. Unlike trid_simd.h these do not depend on the
+// FPPREC macro, so the float and double solvers are instantiated from the same templates in one object.
+//
+// The vector ISA is the one the translation unit is compiled for. Every definition is placed in the TRID_ISA_NS
+// namespace, so that objects built for different ISAs can be linked into the same library.
+//
+#ifdef __MIC__ // Or #ifdef __KNC__ - more general option, future proof, __INTEL_OFFLOAD is another option
+  #include "mic/micvec.h"
+#elif defined(__AVX__) || defined(__SSE4_2__)
+  #include "dvec.h"
+#else
+  #error "No vector ISA intrinsics are defined. "
+#endif
+
+#ifndef TRID_ISA_NS
+  #define TRID_ISA_NS trid_native
+#endif
+
+// Gather and scatter of the lanes of a register from memory lanes(stride) elements apart, also of the lanes of a mask
+#if (defined(__AVX512F__) || defined(__AVX2__)) && !defined(__MIC__)
+  #define TRID_SIMD_GATHER
+#endif
+
+// Unaligned loads and stores of the first lanes of a register, the other lanes are filled from a register and not stored
+#if (defined(__AVX512F__) || defined(__AVX__)) && !defined(__MIC__)
+  #define TRID_SIMD_MASK
+#endif
+
+// Conversion of a float register to and from two double registers, and loads of reduced precision coefficients:
+// bfloat16 and float to double everywhere, IEEE half with F16C or AVX-512
+#ifndef __MIC__
+  #define TRID_SIMD_CONVERT
+  #define TRID_SIMD_PACKED // Deinterleaving of packed {a,b,c,d} elements, see simd_packed
+  #if defined(__F16C__) || defined(__AVX512F__)
+    #define TRID_SIMD_F16
+  #endif
+#endif
+
+namespace TRID_ISA_NS {
+
+#include "transpose.hpp" // Has no includes of its own
+
+template<typename REAL> struct simd_traits;
+
+#ifdef __MIC__
+// Xeon Phi float
+template<> struct simd_traits<float> {
+  typedef __m512   reg;    // Name of Packed REGister
+  typedef F32vec16 vector; // dvec class of the packed register
+  enum { width = 64, vec = width/sizeof(float) }; // Width of SIMD vector unit in bytes and number of elements
+  static inline reg  set1(float x)              { return _mm512_set1_ps(x); }
+  static inline reg  add(reg a, reg b)          { return _mm512_add_ps(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm512_sub_ps(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm512_mul_ps(a,b); }
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm512_fnmadd_ps(a,b,c); } // c - a*b
+  static inline reg  rcp(reg a)                 { return _mm512_rcp23_ps(a); }
+  static inline void transpose(reg *r)          { transpose16x16_intrinsic(r); }
+  static inline void stream(float *p, reg r)    { _mm512_storenrngo_ps(p,r); } // Non-temporal store
+};
+
+// Xeon Phi double
+template<> struct simd_traits<double> {
+  typedef __m512d reg;
+  typedef F64vec8 vector;
+  enum { width = 64, vec = width/sizeof(double) };
+  static inline reg  set1(double x)             { return _mm512_set1_pd(x); }
+  static inline reg  add(reg a, reg b)          { return _mm512_add_pd(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm512_sub_pd(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm512_mul_pd(a,b); }
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm512_fnmadd_pd(a,b,c); }
+  static inline reg  rcp(reg a)                 { return _mm512_div_pd(_mm512_set1_pd(1.0),a); } // Instrinsic doesn't exist
+  static inline void transpose(reg *r)          { transpose8x8_intrinsic(r); }
+  static inline void stream(double *p, reg r)   { _mm512_storenrngo_pd(p,r); }
+};
+#elif defined(__AVX512F__)
+// AVX-512 float
+template<> struct simd_traits<float> {
+  typedef __m512   reg;    // Name of Packed REGister
+  typedef F32vec16 vector; // dvec class of the packed register
+  enum { width = 64, vec = width/sizeof(float) }; // Width of SIMD vector unit in bytes and number of elements
+  static inline reg  set1(float x)              { return _mm512_set1_ps(x); }
+  static inline reg  add(reg a, reg b)          { return _mm512_add_ps(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm512_sub_ps(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm512_mul_ps(a,b); }
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm512_fnmadd_ps(a,b,c); } // c - a*b
+  static inline reg  rcp(reg a)                 { return _mm512_rcp14_ps(a); }
+  static inline void transpose(reg *r)          { transpose16x16_intrinsic(r); }
+  static inline void stream(float *p, reg r)    { _mm512_stream_ps(p,r); } // Non-temporal store, p is aligned
+  typedef __m512i index; // Element offsets of the lanes for gather and scatter
+  static inline index lanes(int stride)         { return _mm512_mullo_epi32(_mm512_set1_epi32(stride), _mm512_set_epi32(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0)); }
+  static inline reg  gather(const float *p, index i)   { return _mm512_i32gather_ps(i, p, sizeof(float)); }
+  static inline void scatter(float *p, index i, reg r) { _mm512_i32scatter_ps(p, i, r, sizeof(float)); }
+  static inline reg  load_f16(const unsigned short *p)  { return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)p)); } // Unaligned
+  static inline reg  load_bf16(const unsigned short *p) { return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)p)),16)); }
+  typedef __mmask16 mask; // Lanes of masked loads and stores
+  static inline mask first(int n)                            { return (mask)((1u<<n)-1); }
+  static inline reg  maskload(const float *p, mask m, reg r) { return _mm512_mask_loadu_ps(r, m, p); }
+  static inline void maskstore(float *p, mask m, reg r)      { _mm512_mask_storeu_ps(p, m, r); }
+  static inline reg  maskgather(const float *p, index i, mask m, reg r) { return _mm512_mask_i32gather_ps(r, m, i, p, sizeof(float)); }
+  static inline void maskscatter(float *p, index i, mask m, reg r)      { _mm512_mask_i32scatter_ps(p, m, i, r, sizeof(float)); }
+};
+
+// AVX-512 double
+template<> struct simd_traits<double> {
+  typedef __m512d reg;
+  typedef F64vec8 vector;
+  enum { width = 64, vec = width/sizeof(double) };
+  static inline reg  set1(double x)             { return _mm512_set1_pd(x); }
+  static inline reg  add(reg a, reg b)          { return _mm512_add_pd(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm512_sub_pd(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm512_mul_pd(a,b); }
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm512_fnmadd_pd(a,b,c); }
+  static inline reg  rcp(reg a)                 { return _mm512_div_pd(_mm512_set1_pd(1.0),a); }
+  static inline void transpose(reg *r)          { transpose8x8_intrinsic(r); }
+  static inline void stream(double *p, reg r)   { _mm512_stream_pd(p,r); }
+  typedef __m256i index;
+  static inline index lanes(int stride)         { return _mm256_mullo_epi32(_mm256_set1_epi32(stride), _mm256_set_epi32(7,6,5,4,3,2,1,0)); }
+  static inline reg  gather(const double *p, index i)   { return _mm512_i32gather_pd(i, p, sizeof(double)); }
+  static inline void scatter(double *p, index i, reg r) { _mm512_i32scatter_pd(p, i, r, sizeof(double)); }
+  static inline reg  load_float(const float *p)         { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+  typedef __mmask8 mask;
+  static inline mask first(int n)                             { return (mask)((1u<<n)-1); }
+  static inline reg  maskload(const double *p, mask m, reg r) { return _mm512_mask_loadu_pd(r, m, p); }
+  static inline void maskstore(double *p, mask m, reg r)      { _mm512_mask_storeu_pd(p, m, r); }
+  static inline reg  maskgather(const double *p, index i, mask m, reg r) { return _mm512_mask_i32gather_pd(r, m, i, p, sizeof(double)); }
+  static inline void maskscatter(double *p, index i, mask m, reg r)      { _mm512_mask_i32scatter_pd(p, m, i, r, sizeof(double)); }
+};
+#elif defined(__AVX__)
+// AVX float (AVX2 with FMA)
+template<> struct simd_traits<float> {
+  typedef __m256  reg;    // Name of Packed REGister
+  typedef F32vec8 vector; // dvec class of the packed register
+  enum { width = 32, vec = width/sizeof(float) }; // Width of SIMD vector unit in bytes and number of elements
+  static inline reg  set1(float x)              { return _mm256_set1_ps(x); }
+  static inline reg  add(reg a, reg b)          { return _mm256_add_ps(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm256_sub_ps(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm256_mul_ps(a,b); }
+#ifdef __FMA__
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm256_fnmadd_ps(a,b,c); } // c - a*b
+#else
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm256_sub_ps(c,_mm256_mul_ps(a,b)); } // c - a*b
+#endif
+  static inline reg  rcp(reg a)                 { return _mm256_rcp_ps(a); }
+  static inline void transpose(reg *r)          { transpose8x8_intrinsic(r); }
+  static inline void stream(float *p, reg r)    { _mm256_stream_ps(p,r); } // Non-temporal store, p is aligned
+#ifdef __AVX2__
+  typedef __m256i index; // Element offsets of the lanes for gather and scatter
+  static inline index lanes(int stride)         { return _mm256_mullo_epi32(_mm256_set1_epi32(stride), _mm256_set_epi32(7,6,5,4,3,2,1,0)); }
+  static inline reg  gather(const float *p, index i)   { return _mm256_i32gather_ps(p, i, sizeof(float)); }
+  static inline void scatter(float *p, index i, reg r) { // AVX2 has no scatter instruction
+    float v[vec]; int o[vec];
+    _mm256_storeu_ps(v, r);
+    _mm256_storeu_si256((__m256i*)o, i);
+    for(int k=0; k<vec; k++) p[o[k]] = v[k];
+  }
+#endif
+#ifdef __F16C__
+  static inline reg  load_f16(const unsigned short *p)  { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)p)); } // Unaligned
+#endif
+  static inline reg  load_bf16(const unsigned short *p) { // Interleaving with zeros shifts the 16 bits to the top of the lanes
+    __m128i h = _mm_loadu_si128((const __m128i*)p);
+    __m128i z = _mm_setzero_si128();
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_castsi128_ps(_mm_unpacklo_epi16(z,h))), _mm_castsi128_ps(_mm_unpackhi_epi16(z,h)), 1);
+  }
+  typedef __m256i mask; // Lanes of masked loads and stores
+  static inline mask first(int n)                            { return _mm256_castps_si256(_mm256_cmp_ps(_mm256_set_ps(7,6,5,4,3,2,1,0), _mm256_set1_ps(n), _CMP_LT_OQ)); }
+  static inline reg  maskload(const float *p, mask m, reg r) { return _mm256_blendv_ps(r, _mm256_maskload_ps(p, m), _mm256_castsi256_ps(m)); }
+  static inline void maskstore(float *p, mask m, reg r)      { _mm256_maskstore_ps(p, m, r); }
+#ifdef __AVX2__
+  static inline reg  maskgather(const float *p, index i, mask m, reg r) { return _mm256_mask_i32gather_ps(r, p, i, _mm256_castsi256_ps(m), sizeof(float)); }
+  static inline void maskscatter(float *p, index i, mask m, reg r) {
+    float v[vec]; int o[vec], l[vec];
+    _mm256_storeu_ps(v, r);
+    _mm256_storeu_si256((__m256i*)o, i);
+    _mm256_storeu_si256((__m256i*)l, m);
+    for(int k=0; k<vec; k++) if(l[k]) p[o[k]] = v[k];
+  }
+#endif
+};
+
+// AVX double
+template<> struct simd_traits<double> {
+  typedef __m256d reg;
+  typedef F64vec4 vector;
+  enum { width = 32, vec = width/sizeof(double) };
+  static inline reg  set1(double x)             { return _mm256_set1_pd(x); }
+  static inline reg  add(reg a, reg b)          { return _mm256_add_pd(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm256_sub_pd(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm256_mul_pd(a,b); }
+#ifdef __FMA__
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm256_fnmadd_pd(a,b,c); }
+#else
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm256_sub_pd(c,_mm256_mul_pd(a,b)); }
+#endif
+  static inline reg  rcp(reg a)                 { return _mm256_div_pd(_mm256_set1_pd(1.0),a); } // Instrinsic doesn't exist
+  static inline void transpose(reg *r)          { transpose4x4_intrinsic(r); }
+  static inline void stream(double *p, reg r)   { _mm256_stream_pd(p,r); }
+#ifdef __AVX2__
+  typedef __m128i index;
+  static inline index lanes(int stride)         { return _mm_mullo_epi32(_mm_set1_epi32(stride), _mm_set_epi32(3,2,1,0)); }
+  static inline reg  gather(const double *p, index i)   { return _mm256_i32gather_pd(p, i, sizeof(double)); }
+  static inline void scatter(double *p, index i, reg r) {
+    double v[vec]; int o[vec];
+    _mm256_storeu_pd(v, r);
+    _mm_storeu_si128((__m128i*)o, i);
+    for(int k=0; k<vec; k++) p[o[k]] = v[k];
+  }
+#endif
+  static inline reg  load_float(const float *p)         { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+  typedef __m256i mask;
+  static inline mask first(int n)                             { return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_set_pd(3,2,1,0), _mm256_set1_pd(n), _CMP_LT_OQ)); }
+  static inline reg  maskload(const double *p, mask m, reg r) { return _mm256_blendv_pd(r, _mm256_maskload_pd(p, m), _mm256_castsi256_pd(m)); }
+  static inline void maskstore(double *p, mask m, reg r)      { _mm256_maskstore_pd(p, m, r); }
+#ifdef __AVX2__
+  static inline reg  maskgather(const double *p, index i, mask m, reg r) { return _mm256_mask_i32gather_pd(r, p, i, _mm256_castsi256_pd(m), sizeof(double)); }
+  static inline void maskscatter(double *p, index i, mask m, reg r) {
+    double v[vec]; int o[vec]; long long l[vec];
+    _mm256_storeu_pd(v, r);
+    _mm_storeu_si128((__m128i*)o, i);
+    _mm256_storeu_si256((__m256i*)l, m);
+    for(int k=0; k<vec; k++) if(l[k]) p[o[k]] = v[k];
+  }
+#endif
+};
+#else
+// SSE4.2 float
+template<> struct simd_traits<float> {
+  typedef __m128  reg;    // Name of Packed REGister
+  typedef F32vec4 vector; // dvec class of the packed register
+  enum { width = 16, vec = width/sizeof(float) }; // Width of SIMD vector unit in bytes and number of elements
+  static inline reg  set1(float x)              { return _mm_set1_ps(x); }
+  static inline reg  add(reg a, reg b)          { return _mm_add_ps(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm_sub_ps(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm_mul_ps(a,b); }
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm_sub_ps(c,_mm_mul_ps(a,b)); } // c - a*b
+  static inline reg  rcp(reg a)                 { return _mm_rcp_ps(a); }
+  static inline void transpose(reg *r)          { transpose4x4_intrinsic(r); }
+  static inline void stream(float *p, reg r)    { _mm_stream_ps(p,r); } // Non-temporal store, p is aligned
+#ifdef __F16C__
+  static inline reg  load_f16(const unsigned short *p)  { return _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)p)); } // Unaligned
+#endif
+  static inline reg  load_bf16(const unsigned short *p) { return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i*)p))); }
+};
+
+// SSE4.2 double
+template<> struct simd_traits<double> {
+  typedef __m128d reg;
+  typedef F64vec2 vector;
+  enum { width = 16, vec = width/sizeof(double) };
+  static inline reg  set1(double x)             { return _mm_set1_pd(x); }
+  static inline reg  add(reg a, reg b)          { return _mm_add_pd(a,b); }
+  static inline reg  sub(reg a, reg b)          { return _mm_sub_pd(a,b); }
+  static inline reg  mul(reg a, reg b)          { return _mm_mul_pd(a,b); }
+  static inline reg  fnmadd(reg a, reg b, reg c){ return _mm_sub_pd(c,_mm_mul_pd(a,b)); }
+  static inline reg  rcp(reg a)                 { return _mm_div_pd(_mm_set1_pd(1.0),a); } // Instrinsic doesn't exist
+  static inline void transpose(reg *r)          { transpose2x2_intrinsic(r); }
+  static inline void stream(double *p, reg r)   { _mm_stream_pd(p,r); }
+  static inline reg  load_float(const float *p)         { return _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double*)p))); }
+};
+#endif
+
+#ifdef TRID_SIMD_CONVERT
+// Float lanes in double precision: lo holds the lower, hi the upper half of the lanes
+struct simd_convert {
+  typedef simd_traits<float>::reg  sreg;
+  typedef simd_traits<double>::reg dreg;
+#if defined(__AVX512F__)
+  static inline void widen(sreg r, dreg &lo, dreg &hi) {
+    lo = _mm512_cvtps_pd(_mm512_castps512_ps256(r));
+    hi = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(r),1)));
+  }
+  static inline sreg narrow(dreg lo, dreg hi) {
+    return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(_mm512_cvtpd_ps(lo))), _mm256_castps_pd(_mm512_cvtpd_ps(hi)), 1));
+  }
+#elif defined(__AVX__)
+  static inline void widen(sreg r, dreg &lo, dreg &hi) {
+    lo = _mm256_cvtps_pd(_mm256_castps256_ps128(r));
+    hi = _mm256_cvtps_pd(_mm256_extractf128_ps(r,1));
+  }
+  static inline sreg narrow(dreg lo, dreg hi) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1);
+  }
+#else
+  static inline void widen(sreg r, dreg &lo, dreg &hi) {
+    lo = _mm_cvtps_pd(r);
+    hi = _mm_cvtps_pd(_mm_movehl_ps(r,r));
+  }
+  static inline sreg narrow(dreg lo, dreg hi) {
+    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+  }
+#endif
+};
+#endif
+
+#ifdef TRID_SIMD_PACKED
+//
+// SIMD_VEC consecutive elements of packed {a,b,c,d} quadruples are 4 registers in memory. load() deinterleaves them
+// into r[0]=a, r[1]=b, r[2]=c and r[3]=d of SIMD_VEC elements. store_d() writes the d of SIMD_VEC elements into the
+// quadruples and leaves a, b and c alone: masked stores with AVX and AVX-512, scalar stores with SSE.
+//
+template<typename REAL> struct simd_packed;
+
+#if defined(__AVX512F__)
+template<> struct simd_packed<float> {
+  typedef simd_traits<float>::reg reg;
+  static inline void load(const float *p, reg *r) {
+    const __m512i ab = _mm512_set_epi32(29,25,21,17,13,9,5,1, 28,24,20,16,12,8,4,0);
+    const __m512i cd = _mm512_set_epi32(31,27,23,19,15,11,7,3, 30,26,22,18,14,10,6,2);
+    const __m512i lo = _mm512_set_epi32(23,22,21,20,19,18,17,16, 7,6,5,4,3,2,1,0);
+    const __m512i hi = _mm512_set_epi32(31,30,29,28,27,26,25,24, 15,14,13,12,11,10,9,8);
+    reg r0 = _mm512_load_ps(p), r1 = _mm512_load_ps(p+16), r2 = _mm512_load_ps(p+32), r3 = _mm512_load_ps(p+48);
+    reg ab0 = _mm512_permutex2var_ps(r0,ab,r1), cd0 = _mm512_permutex2var_ps(r0,cd,r1); // Elements 0-7
+    reg ab1 = _mm512_permutex2var_ps(r2,ab,r3), cd1 = _mm512_permutex2var_ps(r2,cd,r3); // Elements 8-15
+    r[0] = _mm512_permutex2var_ps(ab0,lo,ab1);
+    r[1] = _mm512_permutex2var_ps(ab0,hi,ab1);
+    r[2] = _mm512_permutex2var_ps(cd0,lo,cd1);
+    r[3] = _mm512_permutex2var_ps(cd0,hi,cd1);
+  }
+  static inline void store_d(float *p, reg d) {
+    for(int i=0; i<4; i++) { // Elements 4*i to 4*i+3 to lanes 3, 7, 11 and 15
+      const __m512i e = _mm512_set_epi32(4*i+3,0,0,0, 4*i+2,0,0,0, 4*i+1,0,0,0, 4*i,0,0,0);
+      _mm512_mask_store_ps(p+16*i, 0x8888, _mm512_permutexvar_ps(e,d));
+    }
+  }
+};
+
+template<> struct simd_packed<double> {
+  typedef simd_traits<double>::reg reg;
+  static inline void load(const double *p, reg *r) {
+    const __m512i ab = _mm512_set_epi64(13,9,5,1, 12,8,4,0);
+    const __m512i cd = _mm512_set_epi64(15,11,7,3, 14,10,6,2);
+    const __m512i lo = _mm512_set_epi64(11,10,9,8, 3,2,1,0);
+    const __m512i hi = _mm512_set_epi64(15,14,13,12, 7,6,5,4);
+    reg r0 = _mm512_load_pd(p), r1 = _mm512_load_pd(p+8), r2 = _mm512_load_pd(p+16), r3 = _mm512_load_pd(p+24);
+    reg ab0 = _mm512_permutex2var_pd(r0,ab,r1), cd0 = _mm512_permutex2var_pd(r0,cd,r1); // Elements 0-3
+    reg ab1 = _mm512_permutex2var_pd(r2,ab,r3), cd1 = _mm512_permutex2var_pd(r2,cd,r3); // Elements 4-7
+    r[0] = _mm512_permutex2var_pd(ab0,lo,ab1);
+    r[1] = _mm512_permutex2var_pd(ab0,hi,ab1);
+    r[2] = _mm512_permutex2var_pd(cd0,lo,cd1);
+    r[3] = _mm512_permutex2var_pd(cd0,hi,cd1);
+  }
+  static inline void store_d(double *p, reg d) {
+    for(int i=0; i<4; i++) { // Elements 2*i and 2*i+1 to lanes 3 and 7
+      const __m512i e = _mm512_set_epi64(2*i+1,0,0,0, 2*i,0,0,0);
+      _mm512_mask_store_pd(p+8*i, 0x88, _mm512_permutexvar_pd(e,d));
+    }
+  }
+};
+#elif defined(__AVX__)
+template<> struct simd_packed<float> {
+  typedef simd_traits<float>::reg reg;
+  // 4x4 transpose in both 128-bit lanes, its own inverse
+  static inline void transpose_lanes(reg *r) {
+    reg t0 = _mm256_unpacklo_ps(r[0],r[1]), t1 = _mm256_unpacklo_ps(r[2],r[3]);
+    reg t2 = _mm256_unpackhi_ps(r[0],r[1]), t3 = _mm256_unpackhi_ps(r[2],r[3]);
+    r[0] = _mm256_shuffle_ps(t0,t1,0x44);
+    r[1] = _mm256_shuffle_ps(t0,t1,0xEE);
+    r[2] = _mm256_shuffle_ps(t2,t3,0x44);
+    r[3] = _mm256_shuffle_ps(t2,t3,0xEE);
+  }
+  static inline void load(const float *p, reg *r) {
+    reg r0 = _mm256_load_ps(p), r1 = _mm256_load_ps(p+8), r2 = _mm256_load_ps(p+16), r3 = _mm256_load_ps(p+24);
+    r[0] = _mm256_permute2f128_ps(r0,r2,0x20); // Elements 0 and 4
+    r[1] = _mm256_permute2f128_ps(r0,r2,0x31); // 1 and 5
+    r[2] = _mm256_permute2f128_ps(r1,r3,0x20); // 2 and 6
+    r[3] = _mm256_permute2f128_ps(r1,r3,0x31); // 3 and 7
+    transpose_lanes(r);
+  }
+  static inline void store_d(float *p, reg d) {
+    const __m256i m  = _mm256_set_epi32(-1,0,0,0, -1,0,0,0);
+    const __m256i e0 = _mm256_set_epi32(1,0,0,0, 0,0,0,0); // Elements 0 and 1 of a 128-bit lane to lanes 3 and 7
+    const __m256i e1 = _mm256_set_epi32(3,0,0,0, 2,0,0,0); // Elements 2 and 3
+    reg lo = _mm256_permute2f128_ps(d,d,0x00), hi = _mm256_permute2f128_ps(d,d,0x11);
+    _mm256_maskstore_ps(p,    m, _mm256_permutevar_ps(lo,e0));
+    _mm256_maskstore_ps(p+8,  m, _mm256_permutevar_ps(lo,e1));
+    _mm256_maskstore_ps(p+16, m, _mm256_permutevar_ps(hi,e0));
+    _mm256_maskstore_ps(p+24, m, _mm256_permutevar_ps(hi,e1));
+  }
+};
+
+template<> struct simd_packed<double> {
+  typedef simd_traits<double>::reg reg;
+  static inline void load(const double *p, reg *r) {
+    for(int i=0; i<4; i++) r[i] = _mm256_load_pd(p+4*i);
+    simd_traits<double>::transpose(r);
+  }
+  static inline void store_d(double *p, reg d) {
+    const __m256i m = _mm256_set_epi64x(-1,0,0,0);
+    reg lo = _mm256_permute2f128_pd(d,d,0x00), hi = _mm256_permute2f128_pd(d,d,0x11);
+    _mm256_maskstore_pd(p,    m, _mm256_permute_pd(lo,0x0)); // Element 0 to lane 3
+    _mm256_maskstore_pd(p+4,  m, _mm256_permute_pd(lo,0x8)); // 1
+    _mm256_maskstore_pd(p+8,  m, _mm256_permute_pd(hi,0x0)); // 2
+    _mm256_maskstore_pd(p+12, m, _mm256_permute_pd(hi,0x8)); // 3
+  }
+};
+#else
+template<> struct simd_packed<float> {
+  typedef simd_traits<float>::reg reg;
+  static inline void load(const float *p, reg *r) {
+    for(int i=0; i<4; i++) r[i] = _mm_load_ps(p+4*i);
+    simd_traits<float>::transpose(r);
+  }
+  static inline void store_d(float *p, reg d) {
+    _mm_store_ss(p+3,  d);
+    _mm_store_ss(p+7,  _mm_shuffle_ps(d,d,0x55));
+    _mm_store_ss(p+11, _mm_shuffle_ps(d,d,0xAA));
+    _mm_store_ss(p+15, _mm_shuffle_ps(d,d,0xFF));
+  }
+};
+
+template<> struct simd_packed<double> {
+  typedef simd_traits<double>::reg reg;
+  static inline void load(const double *p, reg *r) {
+    reg r0 = _mm_load_pd(p), r1 = _mm_load_pd(p+2), r2 = _mm_load_pd(p+4), r3 = _mm_load_pd(p+6);
+    r[0] = _mm_unpacklo_pd(r0,r2);
+    r[1] = _mm_unpackhi_pd(r0,r2);
+    r[2] = _mm_unpacklo_pd(r1,r3);
+    r[3] = _mm_unpackhi_pd(r1,r3);
+  }
+  static inline void store_d(double *p, reg d) {
+    _mm_store_sd(p+3, d);
+    _mm_storeh_pd(p+7, d);
+  }
+};
+#endif
+#endif
+
+} // namespace TRID_ISA_NS
+
+#endif